@@ -0,0 +1,247 @@
+#include <cstdio>
+#include <cmath>
+
+#include "batch_sa.h"
+#include "cost2D.h"
+#include "move2D.h"
+#include "best_state.h"
+#include "rng.h"
+#include "schedule.h"
+#include "threads.h"
+
+// ----------------------------------------------------------
+// One speculative move: swap m1 <-> m2, or move m1 to (tr, tc)
+// when m2 == -1
+// ----------------------------------------------------------
+struct SpecMove {
+    int m1, m2;
+    int tr, tc;
+    double r;       // acceptance sample, drawn at proposal time
+    int delta;      // evaluated against the batch-start placement
+};
+
+// Work handed to the pool for one batch
+struct SpecBatch {
+    Netlist* net;
+    const unsigned int* pos;
+    SpecMove* moves;
+    int count;
+    int workers;
+};
+
+static int evaluateSpecMove(Netlist* net, const unsigned int pos[], const SpecMove* mv) {
+    return (mv->m2 < 0)
+        ? computeDeltaCostMovePacked2D(net, pos, mv->m1, mv->tr, mv->tc)
+        : computeDeltaCostSwapPacked2D(net, pos, mv->m1, mv->m2);
+}
+
+// Worker w evaluates a contiguous slice of the batch (read-only)
+static void evaluateSlice(void* ctx, int w) {
+    SpecBatch* b = (SpecBatch*)ctx;
+    int begin = (int)((long long)b->count * w / b->workers);
+    int end   = (int)((long long)b->count * (w + 1) / b->workers);
+
+    for (int k = begin; k < end; k++)
+        b->moves[k].delta = evaluateSpecMove(b->net, b->pos, &b->moves[k]);
+}
+
+// Stamp a module and its neighbors: their later deltas in this batch are stale
+static void markDirty(Netlist* net, int dirty[], int stamp, int module) {
+    dirty[module] = stamp;
+    for (int e = net->offsets[module]; e < net->offsets[module + 1]; e++)
+        dirty[net->neighbors[e]] = stamp;
+}
+
+long long speculativeAnnealing2D(Grid* g, Netlist* net, int mod_x[], int mod_y[],
+                                 int moduleCount, const SAParams* params,
+                                 int threads, int batchSize)
+{
+    SAParams defaults;
+    initSAParams(&defaults);
+    if (!params) params = &defaults;
+
+    if (params->costModel == COST_HPWL) {
+        printf("Speculative annealing supports the clique model only; running serially.\n");
+        return simulatedAnnealing2D(g, net, mod_x, mod_y, moduleCount, params);
+    }
+
+    if (threads <= 0) threads = hardwareThreads();
+    if (batchSize <= 0) batchSize = BSA_DEFAULT_BATCH;
+
+    int* movable = new int[moduleCount];
+    int movableCount = buildMovableList(params->isFixed, moduleCount, movable);
+
+    initGridPositions(g, moduleCount);
+    long long currentCost = computeCost2D(net, mod_x, mod_y);
+    long long bestCost = currentCost;
+
+    if (movableCount < 2) {
+        printf("Nothing to anneal: %d movable module(s).\n", movableCount);
+        delete[] movable;
+        return currentCost;
+    }
+
+    // -------------------------------------------------------
+    // Schedule (T0 from random swap deltas, as the serial annealer)
+    // -------------------------------------------------------
+    Rng* rng = threadRng();
+    int sampleCount = movableCount < 1000 ? movableCount : 1000;
+    int* deltas = new int[sampleCount];
+    for (int k = 0; k < sampleCount; k++) {
+        int a, b;
+        generateRandomMovablePair(movable, movableCount, &a, &b);
+        deltas[k] = computeDeltaCostSwapPacked2D(net, g->modPos, a, b);
+    }
+
+    AnnealSchedule sched;
+    initSchedule(&sched, params->t0Scale * initialTemperature(deltas, sampleCount),
+                 net->netCount);
+    delete[] deltas;
+
+    BestState2D best;
+    initBestState2D(&best, moduleCount, 0);
+
+    SpecMove* moves = new SpecMove[batchSize];
+    int* dirty = new int[moduleCount];
+    for (int m = 0; m < moduleCount; m++) dirty[m] = 0;
+    int stamp = 0;
+
+    WorkerPool* pool = createWorkerPool(threads);
+
+    SpecBatch batch;
+    batch.net = net;
+    batch.pos = g->modPos;
+    batch.moves = moves;
+    batch.workers = threads;
+
+    int window = params->moveGen == MOVE_WINDOW;
+    double rlim = (g->rows > g->cols) ? g->rows : g->cols;
+    int iterationsPerT = movableCount;
+    long long evaluated = 0, reevaluated = 0, dropped = 0;
+
+    printf("Speculative annealing: %d threads, batch %d, T0 = %.2f\n",
+           threads, batchSize, sched.T / WEIGHT_ONE);
+
+    while (!sched.done) {
+        double T = sched.T;
+        int accepted = 0;
+
+        for (int done = 0; done < iterationsPerT; done += batchSize) {
+            int want = iterationsPerT - done < batchSize ? iterationsPerT - done : batchSize;
+
+            // -------------------------------------------------------
+            // 1. Propose (sequential RNG, batch-start placement)
+            // -------------------------------------------------------
+            int count = 0;
+            for (int k = 0; k < want; k++) {
+                SpecMove* mv = &moves[count];
+                mv->m1 = movable[rngBounded(rng, (uint32_t)movableCount)];
+
+                int toEmpty = params->emptyMoveRate > 0.0 && g->freeCount > 0 &&
+                              rngUniform(rng) < params->emptyMoveRate;
+
+                if (toEmpty) {
+                    int found = window
+                        ? sampleFreeSiteNear2D(g, mod_x[mv->m1], mod_y[mv->m1], (int)rlim,
+                                               &mv->tr, &mv->tc)
+                        : sampleFreeSite2D(g, &mv->tr, &mv->tc);
+                    if (!found) continue;
+                    mv->m2 = -1;
+                } else if (window) {
+                    if (!generateWindowPartner2D(g, mod_x, mod_y, params->isFixed,
+                                                 mv->m1, (int)rlim, &mv->m2))
+                        continue;
+                } else {
+                    do {
+                        mv->m2 = movable[rngBounded(rng, (uint32_t)movableCount)];
+                    } while (mv->m2 == mv->m1);
+                }
+
+                mv->r = rngUniform(rng);
+                count++;
+            }
+
+            // -------------------------------------------------------
+            // 2. Evaluate all deltas in parallel (placement read-only)
+            // -------------------------------------------------------
+            batch.count = count;
+            runOnPool(pool, evaluateSlice, &batch);
+            evaluated += count;
+
+            // -------------------------------------------------------
+            // 3. Commit in proposal order
+            // -------------------------------------------------------
+            stamp++;
+            for (int k = 0; k < count; k++) {
+                SpecMove* mv = &moves[k];
+                int m1 = mv->m1;
+                int m2 = mv->m2;
+
+                // target filled by an earlier move of this batch
+                if (m2 < 0 && g->cells[mv->tr * g->cols + mv->tc] != EMPTY_CELL) {
+                    dropped++;
+                    continue;
+                }
+
+                int delta = mv->delta;
+                if (dirty[m1] == stamp || (m2 >= 0 && dirty[m2] == stamp)) {
+                    delta = evaluateSpecMove(net, g->modPos, mv);
+                    reevaluated++;
+                }
+
+                if (delta > 0 && mv->r >= exp(-((double)delta) / T))
+                    continue;
+
+                int old_x = mod_x[m1];
+                int old_y = mod_y[m1];
+                if (m2 < 0)
+                    moveModuleTo(g, mod_x, mod_y, m1, mv->tr, mv->tc);
+                else
+                    applySwapMove2D(g, mod_x, mod_y, m1, m2);
+
+                markDirty(net, dirty, stamp, m1);
+                if (m2 >= 0) markDirty(net, dirty, stamp, m2);
+
+                currentCost += delta;
+                accepted++;
+
+                if (currentCost < bestCost) {
+                    bestCost = currentCost;
+                    markBest2D(&best);
+                } else if (m2 < 0) {
+                    recordMoveBest2D(&best, mod_x, mod_y, m1, old_x, old_y);
+                } else {
+                    recordSwapBest2D(&best, mod_x, mod_y, m1, m2);
+                }
+            }
+        }
+
+        advanceSchedule(&sched, accepted, iterationsPerT, currentCost);
+
+        if (params->verbose)
+            printf("T = %.2f, Current Cost = %lld, Best = %lld, Accepted = %.1f%%\n",
+                   T / WEIGHT_ONE, currentCost, bestCost, 100.0 * sched.acceptRate);
+
+        if (window)
+            rlim = updateWindowLimit2D(g, rlim, sched.acceptRate);
+    }
+
+    restoreBest2D(&best, mod_x, mod_y);
+
+    clearGrid(g);
+    for (int m = 0; m < moduleCount; m++)
+        placeModuleAt(g, m, mod_x[m], mod_y[m]);
+
+    printf("Final Best 2D Cost: %lld after %d temperatures\n", bestCost, sched.temps);
+    printf("Speculation: %lld moves, %.1f%% re-evaluated, %.1f%% dropped\n",
+           evaluated, evaluated ? 100.0 * reevaluated / evaluated : 0.0,
+           evaluated ? 100.0 * dropped / evaluated : 0.0);
+
+    destroyWorkerPool(pool);
+    freeBestState2D(&best);
+    delete[] dirty;
+    delete[] moves;
+    delete[] movable;
+
+    return bestCost;
+}
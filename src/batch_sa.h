@@ -0,0 +1,36 @@
+#ifndef BATCH_SA_H
+#define BATCH_SA_H
+
+#include "grid.h"
+#include "netlist.h"
+#include "sa_timing.h"
+
+// ----------------------------------------------------------
+// Speculative batched annealing of one placement
+//
+// Moves are proposed batchSize at a time (swaps and moves to
+// empty cells, as the serial annealer), each with its acceptance
+// sample drawn up front. Their deltas are then evaluated by a
+// worker pool against the unchanged placement, and the batch is
+// committed in proposal order. A delta goes stale only if an
+// earlier accepted move of the batch moved one of its modules or
+// one of their neighbors; such moves are re-evaluated on the
+// committed placement before the acceptance test, so every
+// decision is the one the sequential algorithm would make for
+// the same move. Moves to a cell an earlier move filled are
+// dropped. Results depend on the seed, not on the thread count.
+//
+// Clique cost model only (HPWL deltas stage into shared net-box
+// scratch); COST_HPWL falls back to simulatedAnnealing2D. Proposals
+// are uniform over the movable modules (no criticality queue).
+// Returns the best cost; the best placement is left in g / mod_x /
+// mod_y. threads <= 0: one per hardware thread; batchSize <= 0:
+// default.
+// ----------------------------------------------------------
+#define BSA_DEFAULT_BATCH 64   // larger batches re-evaluate more stale deltas
+
+long long speculativeAnnealing2D(Grid* g, Netlist* net, int mod_x[], int mod_y[],
+                                 int moduleCount, const SAParams* params,
+                                 int threads, int batchSize);
+
+#endif
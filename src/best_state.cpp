@@ -0,0 +1,93 @@
+#include "best_state.h"
+
+// Undo the journal on xs/ys, newest record first
+static void undoJournal(const BestState2D* s, int xs[], int ys[]) {
+    for (int i = s->journalSize - 1; i >= 0; i--) {
+        const int* rec = &s->journal[3 * i];
+        xs[rec[0]] = rec[1];
+        ys[rec[0]] = rec[2];
+    }
+}
+
+void initBestState2D(BestState2D* s, int moduleCount, int journalCap) {
+    s->moduleCount = moduleCount;
+    s->best_x = new int[moduleCount];
+    s->best_y = new int[moduleCount];
+
+    s->journalCap = (journalCap > 0) ? journalCap : moduleCount;
+    s->journal = new int[3 * (s->journalCap + 2)];   // room for one swap past the cap
+    s->journalSize = 0;
+
+    s->materialized = 0;
+    s->copies = 0;
+}
+
+void freeBestState2D(BestState2D* s) {
+    delete[] s->best_x;
+    delete[] s->best_y;
+    delete[] s->journal;
+    s->best_x = nullptr;
+    s->best_y = nullptr;
+    s->journal = nullptr;
+}
+
+static inline void pushRecord(BestState2D* s, int module, int x, int y) {
+    int* rec = &s->journal[3 * s->journalSize++];
+    rec[0] = module;
+    rec[1] = x;
+    rec[2] = y;
+}
+
+// ----------------------------------------------------------
+// Copy the best out once the journal is full
+// ----------------------------------------------------------
+static void checkJournal(BestState2D* s, const int mod_x[], const int mod_y[]) {
+    if (s->journalSize < s->journalCap) return;
+
+    for (int i = 0; i < s->moduleCount; i++) {
+        s->best_x[i] = mod_x[i];
+        s->best_y[i] = mod_y[i];
+    }
+    undoJournal(s, s->best_x, s->best_y);
+
+    s->journalSize = 0;
+    s->materialized = 1;
+    s->copies++;
+}
+
+void recordSwapBest2D(BestState2D* s, const int mod_x[], const int mod_y[], int m1, int m2) {
+    if (s->materialized) return;
+
+    // before the swap each module sat where the other one is now
+    pushRecord(s, m1, mod_x[m2], mod_y[m2]);
+    pushRecord(s, m2, mod_x[m1], mod_y[m1]);
+    checkJournal(s, mod_x, mod_y);
+}
+
+void recordMoveBest2D(BestState2D* s, const int mod_x[], const int mod_y[],
+                      int module, int old_x, int old_y)
+{
+    if (s->materialized) return;
+
+    pushRecord(s, module, old_x, old_y);
+    checkJournal(s, mod_x, mod_y);
+}
+
+void markBest2D(BestState2D* s) {
+    s->journalSize = 0;
+    s->materialized = 0;
+}
+
+void restoreBest2D(BestState2D* s, int mod_x[], int mod_y[]) {
+    if (s->materialized) {
+        for (int i = 0; i < s->moduleCount; i++) {
+            mod_x[i] = s->best_x[i];
+            mod_y[i] = s->best_y[i];
+        }
+    } else {
+        undoJournal(s, mod_x, mod_y);
+    }
+
+    // the restored placement is the current one again
+    markBest2D(s);
+}
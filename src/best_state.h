@@ -0,0 +1,48 @@
+#ifndef BEST_STATE_H
+#define BEST_STATE_H
+
+// ----------------------------------------------------------
+// Best-placement tracker with an undo journal
+//
+// The journal logs the previous (x, y) of every module changed
+// since the best. While it is active, the best placement is the
+// current one with the journal undone (newest first), so a new
+// best costs O(1) (the journal is just cleared). Only when the
+// journal outgrows its capacity is the best placement copied
+// out to best_x/best_y; the journal then stays off until the
+// next improvement. With capacity ~ moduleCount the copies
+// amortize to O(1) per accepted move.
+// ----------------------------------------------------------
+struct BestState2D {
+    int moduleCount;
+    int* best_x;          // valid when materialized
+    int* best_y;
+
+    int* journal;         // records since the best: module, old x, old y
+    int journalSize;      // records
+    int journalCap;       // records
+
+    int materialized;     // 1: best_x/best_y hold the best, journal off
+    long long copies;     // full copies made (stats)
+};
+
+// Start tracking with the current placement as the best.
+// journalCap <= 0 picks moduleCount.
+void initBestState2D(BestState2D* s, int moduleCount, int journalCap);
+void freeBestState2D(BestState2D* s);
+
+// Record an accepted swap (after it was applied to mod_x/mod_y)
+void recordSwapBest2D(BestState2D* s, const int mod_x[], const int mod_y[], int m1, int m2);
+
+// Record an accepted move of module from (old_x, old_y)
+// (after it was applied to mod_x/mod_y)
+void recordMoveBest2D(BestState2D* s, const int mod_x[], const int mod_y[],
+                      int module, int old_x, int old_y);
+
+// The current placement is the new best
+void markBest2D(BestState2D* s);
+
+// Write the best placement into mod_x/mod_y
+void restoreBest2D(BestState2D* s, int mod_x[], int mod_y[]);
+
+#endif
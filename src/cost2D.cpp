@@ -1,6 +1,7 @@
 #include <cstdio>
 #include "netlist.h"
 #include "cost2D.h"
+#include "delta_simd.h"
 
 // ----------------------------------------------------------
 // Manhattan distance |x1 - x2| + |y1 - y2|
@@ -18,32 +19,31 @@ int manhattanDistance2D(int x1, int y1, int x2, int y2) {
 // ----------------------------------------------------------
 // Full placement cost (no double-counting):
 // For each module m, only count edges where neigh > m.
+// Each distance is scaled by its fixed-point edge weight.
 // ----------------------------------------------------------
-int computeCost2D(Netlist* net, int mod_x[], int mod_y[]) {
+long long computeCost2D(Netlist* net, int mod_x[], int mod_y[]) {
 
     long long total = 0;
 
     for (int m = 0; m < net->moduleCount; m++) {
-        Node* curr = net->adj[m];
+        int x1 = mod_x[m];
+        int y1 = mod_y[m];
 
-        while (curr != NULL) {
-            int neigh = curr->module;
+        for (int e = net->offsets[m]; e < net->offsets[m + 1]; e++) {
+            int neigh = net->neighbors[e];
 
             // Prevent double counting of undirected edge
             if (neigh > m) {
-                int x1 = mod_x[m];
-                int y1 = mod_y[m];
                 int x2 = mod_x[neigh];
                 int y2 = mod_y[neigh];
 
-                total += manhattanDistance2D(x1, y1, x2, y2);
+                total += (long long)net->edgeWeights[e] *
+                         manhattanDistance2D(x1, y1, x2, y2);
             }
-
-            curr = curr->next;
         }
     }
 
-    return (int)total;
+    return total;
 }
 
 // ----------------------------------------------------------
@@ -51,8 +51,12 @@ int computeCost2D(Netlist* net, int mod_x[], int mod_y[]) {
 //
 // Only edges incident to m1 or m2 change.
 // Adjacency contains directed edges but we only
-// scan adj[m1] and adj[m2], so each affected edge
-// is touched once per endpoint.
+// scan the CSR rows of m1 and m2, so each affected
+// edge is touched once per endpoint. The weighted
+// delta stays in integer fixed-point units.
+//
+// The row scans run through rowDelta2D (delta_simd),
+// which uses AVX2/AVX-512 when the CPU has it.
 // ----------------------------------------------------------
 int computeDeltaCostSwap2D(Netlist* net, int mod_x[], int mod_y[],
                            int m1, int m2)
@@ -60,51 +64,16 @@ int computeDeltaCostSwap2D(Netlist* net, int mod_x[], int mod_y[],
     int old_x1 = mod_x[m1], old_y1 = mod_y[m1];
     int old_x2 = mod_x[m2], old_y2 = mod_y[m2];
 
-    long long delta = 0;
-
-    // neighbors of m1
-    Node* curr = net->adj[m1];
-    while (curr != NULL) {
-        int neigh = curr->module;
-
-        if (neigh == m2) {
-            // distance between m1 and m2 is symmetric and
-            // unchanged by swapping positions, so ignore.
-            curr = curr->next;
-            continue;
-        }
-
-        int xn = mod_x[neigh];
-        int yn = mod_y[neigh];
-
-        int oldDist = manhattanDistance2D(old_x1, old_y1, xn, yn);
-        int newDist = manhattanDistance2D(old_x2, old_y2, xn, yn);
-
-        delta += (newDist - oldDist);
-
-        curr = curr->next;
-    }
+    // neighbors of m1 (the m1-m2 edge is symmetric and
+    // unchanged by swapping positions, so it is skipped)
+    unsigned int delta = (unsigned int)rowDelta2D(
+        net->neighbors, net->edgeWeights, net->offsets[m1], net->offsets[m1 + 1],
+        mod_x, mod_y, old_x1, old_y1, old_x2, old_y2, m2);
 
     // neighbors of m2
-    curr = net->adj[m2];
-    while (curr != NULL) {
-        int neigh = curr->module;
-
-        if (neigh == m1) {
-            curr = curr->next;
-            continue;
-        }
-
-        int xn = mod_x[neigh];
-        int yn = mod_y[neigh];
-
-        int oldDist = manhattanDistance2D(old_x2, old_y2, xn, yn);
-        int newDist = manhattanDistance2D(old_x1, old_y1, xn, yn);
-
-        delta += (newDist - oldDist);
-
-        curr = curr->next;
-    }
+    delta += (unsigned int)rowDelta2D(
+        net->neighbors, net->edgeWeights, net->offsets[m2], net->offsets[m2 + 1],
+        mod_x, mod_y, old_x2, old_y2, old_x1, old_y1, m1);
 
     return (int)delta;
 }
@@ -116,26 +85,58 @@ int computeDeltaCostSwap2D(Netlist* net, int mod_x[], int mod_y[],
 int computeDeltaCostMove2D(Netlist* net, int mod_x[], int mod_y[],
                            int module, int new_x, int new_y)
 {
-    int old_x = mod_x[module];
-    int old_y = mod_y[module];
-
-    long long delta = 0;
+    return rowDelta2D(net->neighbors, net->edgeWeights,
+                      net->offsets[module], net->offsets[module + 1],
+                      mod_x, mod_y, mod_x[module], mod_y[module], new_x, new_y, -1);
+}
 
-    Node* curr = net->adj[module];
+// ----------------------------------------------------------
+// Packed-position variants (pos[m] = POS_PACK(row, col))
+// ----------------------------------------------------------
+long long computeCostPacked2D(Netlist* net, const unsigned int pos[]) {
 
-    while (curr != NULL) {
-        int neigh = curr->module;
+    long long total = 0;
 
-        int xn = mod_x[neigh];
-        int yn = mod_y[neigh];
+    for (int m = 0; m < net->moduleCount; m++) {
+        unsigned int p1 = pos[m];
 
-        int oldDist = manhattanDistance2D(old_x, old_y, xn, yn);
-        int newDist = manhattanDistance2D(new_x, new_y, xn, yn);
+        for (int e = net->offsets[m]; e < net->offsets[m + 1]; e++) {
+            int neigh = net->neighbors[e];
 
-        delta += (newDist - oldDist);
+            if (neigh > m) {
+                unsigned int p2 = pos[neigh];
 
-        curr = curr->next;
+                total += (long long)net->edgeWeights[e] *
+                         manhattanDistance2D(POS_ROW(p1), POS_COL(p1),
+                                             POS_ROW(p2), POS_COL(p2));
+            }
+        }
     }
 
+    return total;
+}
+
+int computeDeltaCostSwapPacked2D(Netlist* net, const unsigned int pos[],
+                                 int m1, int m2)
+{
+    unsigned int p1 = pos[m1];
+    unsigned int p2 = pos[m2];
+
+    unsigned int delta = (unsigned int)rowDeltaPacked2D(
+        net->neighbors, net->edgeWeights, net->offsets[m1], net->offsets[m1 + 1],
+        pos, p1, p2, m2);
+
+    delta += (unsigned int)rowDeltaPacked2D(
+        net->neighbors, net->edgeWeights, net->offsets[m2], net->offsets[m2 + 1],
+        pos, p2, p1, m1);
+
     return (int)delta;
 }
+
+int computeDeltaCostMovePacked2D(Netlist* net, const unsigned int pos[],
+                                 int module, int new_x, int new_y)
+{
+    return rowDeltaPacked2D(net->neighbors, net->edgeWeights,
+                            net->offsets[module], net->offsets[module + 1],
+                            pos, pos[module], POS_PACK(new_x, new_y), -1);
+}
@@ -7,8 +7,12 @@
 // Manhattan distance for 2D placement
 int manhattanDistance2D(int x1, int y1, int x2, int y2);
 
+// Costs are weighted by the fixed-point edge weights (see netlist.h).
+// Full costs are long long: the WEIGHT_ONE scaling pushes large
+// designs past INT_MAX. Move deltas stay int.
+
 // Full cost of placement
-int computeCost2D(Netlist* net, int mod_x[], int mod_y[]);
+long long computeCost2D(Netlist* net, int mod_x[], int mod_y[]);
 
 // Incremental delta cost for swapping two modules m1 and m2
 int computeDeltaCostSwap2D(Netlist* net, int mod_x[], int mod_y[], int m1, int m2);
@@ -16,4 +20,13 @@ int computeDeltaCostSwap2D(Netlist* net, int mod_x[], int mod_y[], int m1, int m
 // Optional: delta cost for moving a module to a new position
 int computeDeltaCostMove2D(Netlist* net, int mod_x[], int mod_y[], int module, int new_x, int new_y);
 
+// ----------------------------------------------------------
+// Same costs over the packed position store (Grid::modPos,
+// see grid.h): one load per neighbor fetches row and column
+// ----------------------------------------------------------
+long long computeCostPacked2D(Netlist* net, const unsigned int pos[]);
+int computeDeltaCostSwapPacked2D(Netlist* net, const unsigned int pos[], int m1, int m2);
+int computeDeltaCostMovePacked2D(Netlist* net, const unsigned int pos[],
+                                 int module, int new_x, int new_y);
+
 #endif
@@ -3,112 +3,390 @@
 #include <cstdlib>
 #include "csv_parser.h"
 #include "netlist.h"
+#include "mapped_file.h"
+#include "threads.h"
 
-// Extract integer from "B_4186"
-static int parseBlockID(const char* token) {
-    if (token[0] != 'B' || token[1] != '_')
-        return -1;
-    return atoi(token + 2);
+// ========================================================
+// Growable int buffer used to collect net pins
+// ========================================================
+struct IntBuffer {
+    int* data;
+    int size;
+    int capacity;
+};
+
+static void pushInt(IntBuffer* buf, int value) {
+    if (buf->size == buf->capacity) {
+        int newCap = buf->capacity ? buf->capacity * 2 : 4096;
+        int* grown = new int[newCap];
+        for (int i = 0; i < buf->size; i++) grown[i] = buf->data[i];
+        delete[] buf->data;
+        buf->data = grown;
+        buf->capacity = newCap;
+    }
+    buf->data[buf->size++] = value;
 }
 
 // ========================================================
-// FIRST PASS — determine max block ID
+// In-place tokenizing helpers over the mapped bytes
+// (p walks forward, end is one past the last byte)
 // ========================================================
-static int scanMaxModuleID(FILE* fp) {
-    char line[8192];
-    int maxID = -1;
+static inline int isFieldSep(char ch) {
+    return ch == ',' || ch == '\t';
+}
+
+static inline int isLineEnd(char ch) {
+    return ch == '\n' || ch == '\r';
+}
+
+// Decimal weight such as "1.0" or "2.75".
+// Returns 0 if the field holds no number (e.g. the header).
+static int parseWeight(const char* p, const char* end, double* out) {
+    int neg = 0;
+    if (p < end && (*p == '-' || *p == '+')) {
+        neg = (*p == '-');
+        p++;
+    }
+
+    int digits = 0;
+    double value = 0.0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10.0 + (*p - '0');
+        p++;
+        digits++;
+    }
 
-    while (fgets(line, sizeof(line), fp)) {
-        if (line[0] == '\n' || line[0] == 0)
+    if (p < end && *p == '.') {
+        p++;
+        double scale = 0.1;
+        while (p < end && *p >= '0' && *p <= '9') {
+            value += (*p - '0') * scale;
+            scale *= 0.1;
+            p++;
+            digits++;
+        }
+    }
+
+    if (digits == 0) return 0;
+    *out = neg ? -value : value;
+    return 1;
+}
+
+// Extract integer from "B_4186"; -1 if the token is not a block
+static int parseBlockID(const char* p, const char* end) {
+    if (end - p < 3 || p[0] != 'B' || p[1] != '_')
+        return -1;
+
+    p += 2;
+    int id = 0;
+    int digits = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        id = id * 10 + (*p - '0');
+        p++;
+        digits++;
+    }
+    return digits ? id : -1;
+}
+
+// ========================================================
+// Single pass over the mapped file:
+//   NetName,Weight,B_x B_y ...
+// Collects the pins and weight of every net and tracks the
+// highest block ID, so no line-length or fanout limits apply.
+// ========================================================
+static void parseNetLines(const char* p, const char* end,
+                          IntBuffer* netOffsets, IntBuffer* netPins,
+                          IntBuffer* netWeights, int* maxID)
+{
+    while (p < end) {
+        // skip blank lines
+        if (isLineEnd(*p)) {
+            p++;
             continue;
+        }
+
+        // ---- field 1: net name ----
+        while (p < end && !isFieldSep(*p) && !isLineEnd(*p)) p++;
+        while (p < end && isFieldSep(*p)) p++;
+
+        // ---- field 2: weight ----
+        const char* weight = p;
+        while (p < end && !isFieldSep(*p) && !isLineEnd(*p)) p++;
+        const char* weightEnd = p;
+        while (p < end && isFieldSep(*p)) p++;
 
-        // Split line into tokens
-        char* save;
-        char* field1 = strtok_r(line, ",\t", &save);  // NetName
-        char* field2 = strtok_r(NULL, ",\t", &save);  // Weight
-        char* field3 = strtok_r(NULL, "\n", &save);   // Blocks
+        double w;
+        if (!parseWeight(weight, weightEnd, &w)) w = 1.0;
 
-        if (!field3) continue;
+        // ---- field 3: space-separated blocks ----
+        int count = 0;
+        while (p < end && !isLineEnd(*p)) {
+            while (p < end && *p == ' ') p++;
+
+            const char* token = p;
+            while (p < end && *p != ' ' && !isLineEnd(*p)) p++;
 
-        char* token;
-        char* bsave;
-        token = strtok_r(field3, " ", &bsave); // space-separated blocks
+            int id = parseBlockID(token, p);
+            if (id >= 0) {
+                pushInt(netPins, id);
+                if (id > *maxID) *maxID = id;
+                count++;
+            }
+        }
 
-        while (token) {
-            int id = parseBlockID(token);
-            if (id > maxID) maxID = id;
-            token = strtok_r(NULL, " ", &bsave);
+        // header and empty nets add no pins
+        if (count > 0) {
+            pushInt(netOffsets, netPins->size);
+            pushInt(netWeights, weightToFixed(w));
         }
     }
-    return maxID;
 }
 
 // ========================================================
-// SECOND PASS — Build adjacency list
+// Multithreaded ingestion
+//
+// The mapped file is cut into chunks at line boundaries; each
+// worker parses its chunk into private buffers. A prefix sum
+// over the per-chunk counts gives every chunk its base, and
+// the workers then copy their nets into the merged arrays in
+// parallel. Chunks keep file order, so the result does not
+// depend on the thread count.
+// ========================================================
+#define PARSE_MIN_CHUNK_BYTES (1 << 20)   // don't split below 1 MB
+
+struct ParseChunk {
+    const char* begin;
+    const char* end;
+
+    IntBuffer netOffsets;   // local: starts at 0
+    IntBuffer netPins;
+    IntBuffer netWeights;
+    int maxID;
+
+    int netBase;            // first global net index
+    int pinBase;            // first global pin index
+};
+
+static void parseChunkWorker(ParseChunk* c) {
+    pushInt(&c->netOffsets, 0);
+    parseNetLines(c->begin, c->end,
+                  &c->netOffsets, &c->netPins, &c->netWeights, &c->maxID);
+}
+
+static void mergeChunkWorker(const ParseChunk* c,
+                             int* netOffsets, int* netPins, int* netWeights)
+{
+    int nets = c->netOffsets.size - 1;
+
+    for (int n = 0; n < nets; n++) {
+        netOffsets[c->netBase + n + 1] = c->pinBase + c->netOffsets.data[n + 1];
+        netWeights[c->netBase + n]     = c->netWeights.data[n];
+    }
+    for (int p = 0; p < c->netPins.size; p++)
+        netPins[c->pinBase + p] = c->netPins.data[p];
+}
+
+// ========================================================
+// Map the file and collect pins into the hypergraph
 // ========================================================
-Netlist* parseCSVNetlist(const char* filename, int* moduleCountOut) {
-    FILE* fp = fopen(filename, "r");
-    if (!fp) {
+Netlist* parseCSVNetlist(const char* filename, int* moduleCountOut, int threads) {
+    MappedFile mf;
+    if (!mapFile(filename, &mf)) {
         printf("ERROR: Cannot open CSV netlist: %s\n", filename);
         return nullptr;
     }
 
     // -------------------------------------------------------
-    // 1. First pass — determine highest module ID
+    // 1. Split at line boundaries
     // -------------------------------------------------------
-    int maxID = scanMaxModuleID(fp);
+    if (threads <= 0) threads = hardwareThreads();
+
+    size_t maxChunks = mf.size / PARSE_MIN_CHUNK_BYTES + 1;
+    int chunkCount = (maxChunks < (size_t)threads) ? (int)maxChunks : threads;
+
+    ParseChunk* chunks = new ParseChunk[chunkCount];
+    const char* fileEnd = mf.data + mf.size;
+    const char* cut = mf.data;
+
+    for (int i = 0; i < chunkCount; i++) {
+        ParseChunk* c = &chunks[i];
+        c->begin = cut;
+
+        if (i == chunkCount - 1) {
+            cut = fileEnd;
+        } else {
+            cut = mf.data + mf.size / chunkCount * (i + 1);
+            if (cut < c->begin) cut = c->begin;
+            while (cut < fileEnd && *cut != '\n') cut++;
+            if (cut < fileEnd) cut++;
+        }
+        c->end = cut;
+
+        c->netOffsets = {nullptr, 0, 0};
+        c->netPins    = {nullptr, 0, 0};
+        c->netWeights = {nullptr, 0, 0};
+        c->maxID = -1;
+    }
+
+    // -------------------------------------------------------
+    // 2. Parse chunks in parallel
+    // -------------------------------------------------------
+    runOnThreads(chunkCount, [chunks](int i) { parseChunkWorker(&chunks[i]); });
+
+    // -------------------------------------------------------
+    // 3. Prefix sum over chunk counts -> global bases
+    // -------------------------------------------------------
+    int netCount = 0, pinCount = 0, maxID = -1;
+    for (int i = 0; i < chunkCount; i++) {
+        chunks[i].netBase = netCount;
+        chunks[i].pinBase = pinCount;
+        netCount += chunks[i].netOffsets.size - 1;
+        pinCount += chunks[i].netPins.size;
+        if (chunks[i].maxID > maxID) maxID = chunks[i].maxID;
+    }
+
+    // -------------------------------------------------------
+    // 4. Merge into flat net -> pins arrays in parallel
+    // -------------------------------------------------------
+    // netOffsets[n] .. netOffsets[n+1] index the pins of net n
+    int* netOffsets = new int[netCount + 1];
+    int* netPins    = new int[pinCount > 0 ? pinCount : 1];
+    int* netWeights = new int[netCount > 0 ? netCount : 1];   // fixed point
+    netOffsets[0] = 0;
+
+    runOnThreads(chunkCount, [=](int i) {
+        mergeChunkWorker(&chunks[i], netOffsets, netPins, netWeights);
+    });
+
+    for (int i = 0; i < chunkCount; i++) {
+        delete[] chunks[i].netOffsets.data;
+        delete[] chunks[i].netPins.data;
+        delete[] chunks[i].netWeights.data;
+    }
+    delete[] chunks;
+
+    unmapFile(&mf);
+
     if (maxID < 0) {
         printf("ERROR: No valid block IDs found.\n");
-        fclose(fp);
+        delete[] netOffsets;
+        delete[] netPins;
+        delete[] netWeights;
         return nullptr;
     }
 
     int moduleCount = maxID + 1;
     *moduleCountOut = moduleCount;
 
-    rewind(fp);
+    // -------------------------------------------------------
+    // Store nets as a hypergraph (no clique expansion here;
+    // call buildCliqueAdjacency if the clique model is used)
+    // -------------------------------------------------------
+    Netlist* net = initNetlistFromNets(moduleCount, netCount,
+                                       netOffsets, netPins, netWeights);
 
-    // NOTE: YOU MUST CALL initNodePool BEFORE THIS FUNCTION
-    Netlist* net = initNetlist(moduleCount);
+    delete[] netOffsets;
+    delete[] netPins;
+    delete[] netWeights;
+    return net;
+}
 
-    char line[8192];
+// ========================================================
+// Blocks file:
+//   BlockName,Initial_X,Initial_Y,IsFixed
+// ========================================================
 
-    // -------------------------------------------------------
-    // 2. Second pass — actually build adjacency
-    // -------------------------------------------------------
-    while (fgets(line, sizeof(line), fp)) {
-        if (line[0] == '\n' || line[0] == 0)
-            continue;
+// Signed integer field; returns 0 if the field holds no digits
+static int parseIntField(const char* p, const char* end, int* out) {
+    int neg = 0;
+    if (p < end && (*p == '-' || *p == '+')) {
+        neg = (*p == '-');
+        p++;
+    }
 
-        char* save;
-        strtok_r(line, ",\t", &save);   // net name
-        strtok_r(NULL, ",\t", &save);   // weight
-        char* blocks = strtok_r(NULL, "\n", &save);
+    int digits = 0;
+    int value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + (*p - '0');
+        p++;
+        digits++;
+    }
 
-        if (!blocks) continue;
+    if (digits == 0) return 0;
+    *out = neg ? -value : value;
+    return 1;
+}
 
-        // List of block IDs for this net
-        int modules[2048];
-        int count = 0;
+int parseCSVBlocks(const char* filename, int moduleCount,
+                   int mod_x[], int mod_y[], char isFixed[])
+{
+    MappedFile mf;
+    if (!mapFile(filename, &mf)) {
+        printf("ERROR: Cannot open CSV blocks file: %s\n", filename);
+        return -1;
+    }
+
+    for (int m = 0; m < moduleCount; m++) {
+        mod_x[m] = -1;
+        mod_y[m] = -1;
+        isFixed[m] = 0;
+    }
+
+    const char* p = mf.data;
+    const char* end = mf.data + mf.size;
 
-        char* bsave;
-        char* token = strtok_r(blocks, " ", &bsave);  // space-separated list
+    int count = 0;
+    int ignored = 0;
 
-        while (token) {
-            int id = parseBlockID(token);
-            if (id >= 0) modules[count++] = id;
-            token = strtok_r(NULL, " ", &bsave);
+    while (p < end) {
+        if (isLineEnd(*p)) {
+            p++;
+            continue;
         }
 
-        // Add all pairwise edges (clique expansion)
-        for (int i = 0; i < count; i++) {
-            for (int j = i + 1; j < count; j++) {
-                addEdge(net, modules[i], modules[j]);
-                addEdge(net, modules[j], modules[i]);
+        // split the line into up to 4 fields
+        const char* field[4];
+        const char* fieldEnd[4];
+        int fields = 0;
+
+        while (p < end && !isLineEnd(*p)) {
+            const char* f = p;
+            while (p < end && !isFieldSep(*p) && !isLineEnd(*p)) p++;
+            if (fields < 4) {
+                field[fields] = f;
+                fieldEnd[fields] = p;
+                fields++;
             }
+            if (p < end && isFieldSep(*p)) p++;
         }
+
+        if (fields < 4) continue;
+
+        // header line has no B_ name
+        int id = parseBlockID(field[0], fieldEnd[0]);
+        if (id < 0) continue;
+
+        int x, y, fixedFlag;
+        if (!parseIntField(field[1], fieldEnd[1], &x)) x = -1;
+        if (!parseIntField(field[2], fieldEnd[2], &y)) y = -1;
+        if (!parseIntField(field[3], fieldEnd[3], &fixedFlag)) fixedFlag = 0;
+
+        // blocks without nets don't affect the cost
+        if (id >= moduleCount) {
+            ignored++;
+            continue;
+        }
+
+        mod_x[id] = x;
+        mod_y[id] = y;
+        isFixed[id] = (fixedFlag != 0);
+        count++;
     }
 
-    fclose(fp);
-    return net;
+    unmapFile(&mf);
+
+    if (ignored > 0)
+        printf("WARNING: %d blocks have IDs beyond the netlist and were ignored.\n", ignored);
+
+    return count;
 }
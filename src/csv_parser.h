@@ -3,7 +3,17 @@
 
 #include "netlist.h"
 
-// Parse a CSV hypergraph netlist file using memory pool + adjacency list
-Netlist* parseCSVNetlist(const char* filename, int* moduleCountOut);
+// Parse a CSV hypergraph netlist file into the Netlist hypergraph
+// (net -> pins and module -> nets; storage comes from the node arena).
+// threads: parser worker threads (0 = one per hardware thread); the
+// result is identical for any thread count.
+Netlist* parseCSVNetlist(const char* filename, int* moduleCountOut, int threads = 0);
+
+// Parse a CSV blocks file (BlockName,Initial_X,Initial_Y,IsFixed).
+// Fills mod_x/mod_y with the initial coordinates (-1 = unplaced) and
+// isFixed with 0/1 for modules [0, moduleCount). Modules not listed are
+// unplaced and movable. Returns the number of blocks read, -1 on error.
+int parseCSVBlocks(const char* filename, int moduleCount,
+                   int mod_x[], int mod_y[], char isFixed[]);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,349 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "delta_simd.h"
+#include "grid.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DELTA_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// ----------------------------------------------------------
+// Scalar kernel (reference; also handles the vector tails)
+// ----------------------------------------------------------
+static inline int absDiff(int a, int b) {
+    int d = a - b;
+    return (d < 0) ? -d : d;
+}
+
+static int rowDeltaScalar(const int* neighbors, const int* weights,
+                          int begin, int end,
+                          const int mod_x[], const int mod_y[],
+                          int old_x, int old_y, int new_x, int new_y,
+                          int skip)
+{
+    // unsigned: wrap-around sums match the vector lanes exactly
+    unsigned int delta = 0;
+
+    for (int e = begin; e < end; e++) {
+        int neigh = neighbors[e];
+        if (neigh == skip) continue;
+
+        int xn = mod_x[neigh];
+        int yn = mod_y[neigh];
+
+        int oldDist = absDiff(old_x, xn) + absDiff(old_y, yn);
+        int newDist = absDiff(new_x, xn) + absDiff(new_y, yn);
+
+        delta += (unsigned int)weights[e] * (unsigned int)(newDist - oldDist);
+    }
+
+    return (int)delta;
+}
+
+static int rowDeltaPackedScalar(const int* neighbors, const int* weights,
+                                int begin, int end,
+                                const unsigned int pos[],
+                                unsigned int oldPos, unsigned int newPos,
+                                int skip)
+{
+    int old_x = POS_ROW(oldPos), old_y = POS_COL(oldPos);
+    int new_x = POS_ROW(newPos), new_y = POS_COL(newPos);
+
+    unsigned int delta = 0;
+
+    for (int e = begin; e < end; e++) {
+        int neigh = neighbors[e];
+        if (neigh == skip) continue;
+
+        unsigned int p = pos[neigh];
+        int xn = POS_ROW(p);
+        int yn = POS_COL(p);
+
+        int oldDist = absDiff(old_x, xn) + absDiff(old_y, yn);
+        int newDist = absDiff(new_x, xn) + absDiff(new_y, yn);
+
+        delta += (unsigned int)weights[e] * (unsigned int)(newDist - oldDist);
+    }
+
+    return (int)delta;
+}
+
+#ifdef DELTA_SIMD_X86
+
+// ----------------------------------------------------------
+// AVX2: 8 neighbors per step (gathered coordinates)
+// ----------------------------------------------------------
+__attribute__((target("avx2")))
+static int rowDeltaAVX2(const int* neighbors, const int* weights,
+                        int begin, int end,
+                        const int mod_x[], const int mod_y[],
+                        int old_x, int old_y, int new_x, int new_y,
+                        int skip)
+{
+    const __m256i vox   = _mm256_set1_epi32(old_x);
+    const __m256i voy   = _mm256_set1_epi32(old_y);
+    const __m256i vnx   = _mm256_set1_epi32(new_x);
+    const __m256i vny   = _mm256_set1_epi32(new_y);
+    const __m256i vskip = _mm256_set1_epi32(skip);
+
+    __m256i acc = _mm256_setzero_si256();
+
+    int e = begin;
+    for (; e + 8 <= end; e += 8) {
+        __m256i idx = _mm256_loadu_si256((const __m256i*)(neighbors + e));
+        __m256i w   = _mm256_loadu_si256((const __m256i*)(weights + e));
+
+        __m256i xs = _mm256_i32gather_epi32(mod_x, idx, 4);
+        __m256i ys = _mm256_i32gather_epi32(mod_y, idx, 4);
+
+        __m256i newDist = _mm256_add_epi32(_mm256_abs_epi32(_mm256_sub_epi32(xs, vnx)),
+                                           _mm256_abs_epi32(_mm256_sub_epi32(ys, vny)));
+        __m256i oldDist = _mm256_add_epi32(_mm256_abs_epi32(_mm256_sub_epi32(xs, vox)),
+                                           _mm256_abs_epi32(_mm256_sub_epi32(ys, voy)));
+
+        // the skipped neighbor contributes nothing
+        w = _mm256_andnot_si256(_mm256_cmpeq_epi32(idx, vskip), w);
+
+        acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(w, _mm256_sub_epi32(newDist, oldDist)));
+    }
+
+    // horizontal sum of the 8 lanes
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    unsigned int delta = (unsigned int)_mm_cvtsi128_si32(sum);
+    delta += (unsigned int)rowDeltaScalar(neighbors, weights, e, end, mod_x, mod_y,
+                                          old_x, old_y, new_x, new_y, skip);
+    return (int)delta;
+}
+
+__attribute__((target("avx2")))
+static int rowDeltaPackedAVX2(const int* neighbors, const int* weights,
+                              int begin, int end,
+                              const unsigned int pos[],
+                              unsigned int oldPos, unsigned int newPos,
+                              int skip)
+{
+    const __m256i vox   = _mm256_set1_epi32(POS_ROW(oldPos));
+    const __m256i voy   = _mm256_set1_epi32(POS_COL(oldPos));
+    const __m256i vnx   = _mm256_set1_epi32(POS_ROW(newPos));
+    const __m256i vny   = _mm256_set1_epi32(POS_COL(newPos));
+    const __m256i vskip = _mm256_set1_epi32(skip);
+    const __m256i vlow  = _mm256_set1_epi32(0xffff);
+
+    __m256i acc = _mm256_setzero_si256();
+
+    int e = begin;
+    for (; e + 8 <= end; e += 8) {
+        __m256i idx = _mm256_loadu_si256((const __m256i*)(neighbors + e));
+        __m256i w   = _mm256_loadu_si256((const __m256i*)(weights + e));
+
+        // one gather fetches row and column
+        __m256i ps = _mm256_i32gather_epi32((const int*)pos, idx, 4);
+        __m256i xs = _mm256_srli_epi32(ps, 16);
+        __m256i ys = _mm256_and_si256(ps, vlow);
+
+        __m256i newDist = _mm256_add_epi32(_mm256_abs_epi32(_mm256_sub_epi32(xs, vnx)),
+                                           _mm256_abs_epi32(_mm256_sub_epi32(ys, vny)));
+        __m256i oldDist = _mm256_add_epi32(_mm256_abs_epi32(_mm256_sub_epi32(xs, vox)),
+                                           _mm256_abs_epi32(_mm256_sub_epi32(ys, voy)));
+
+        w = _mm256_andnot_si256(_mm256_cmpeq_epi32(idx, vskip), w);
+
+        acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(w, _mm256_sub_epi32(newDist, oldDist)));
+    }
+
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    unsigned int delta = (unsigned int)_mm_cvtsi128_si32(sum);
+    delta += (unsigned int)rowDeltaPackedScalar(neighbors, weights, e, end, pos,
+                                                oldPos, newPos, skip);
+    return (int)delta;
+}
+
+// ----------------------------------------------------------
+// AVX-512: 16 neighbors per step, masked tail
+// ----------------------------------------------------------
+// |v| via the zero-masked form (GCC's unmasked _mm512_abs_epi32
+// trips -Wuninitialized on its undefined pass-through operand)
+__attribute__((target("avx512f")))
+static inline __m512i abs512(__m512i v) {
+    return _mm512_maskz_abs_epi32((__mmask16)0xffff, v);
+}
+
+__attribute__((target("avx512f")))
+static int rowDeltaAVX512(const int* neighbors, const int* weights,
+                          int begin, int end,
+                          const int mod_x[], const int mod_y[],
+                          int old_x, int old_y, int new_x, int new_y,
+                          int skip)
+{
+    const __m512i vox   = _mm512_set1_epi32(old_x);
+    const __m512i voy   = _mm512_set1_epi32(old_y);
+    const __m512i vnx   = _mm512_set1_epi32(new_x);
+    const __m512i vny   = _mm512_set1_epi32(new_y);
+    const __m512i vskip = _mm512_set1_epi32(skip);
+
+    __m512i acc = _mm512_setzero_si512();
+
+    for (int e = begin; e < end; e += 16) {
+        int left = end - e;
+        __mmask16 live = (left >= 16) ? (__mmask16)0xffff : (__mmask16)((1u << left) - 1);
+
+        __m512i idx = _mm512_maskz_loadu_epi32(live, neighbors + e);
+        __m512i w   = _mm512_maskz_loadu_epi32(live, weights + e);
+
+        // dead lanes and the skipped neighbor get weight 0
+        live = _mm512_mask_cmpneq_epi32_mask(live, idx, vskip);
+
+        __m512i xs = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), live, idx, mod_x, 4);
+        __m512i ys = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), live, idx, mod_y, 4);
+
+        __m512i newDist = _mm512_add_epi32(abs512(_mm512_sub_epi32(xs, vnx)),
+                                           abs512(_mm512_sub_epi32(ys, vny)));
+        __m512i oldDist = _mm512_add_epi32(abs512(_mm512_sub_epi32(xs, vox)),
+                                           abs512(_mm512_sub_epi32(ys, voy)));
+
+        __m512i term = _mm512_mullo_epi32(w, _mm512_sub_epi32(newDist, oldDist));
+        acc = _mm512_mask_add_epi32(acc, live, acc, term);
+    }
+
+    // horizontal sum of the 16 lanes
+    alignas(64) int lanes[16];
+    _mm512_store_si512((__m512i*)lanes, acc);
+
+    unsigned int delta = 0;
+    for (int i = 0; i < 16; i++) delta += (unsigned int)lanes[i];
+    return (int)delta;
+}
+
+__attribute__((target("avx512f")))
+static int rowDeltaPackedAVX512(const int* neighbors, const int* weights,
+                                int begin, int end,
+                                const unsigned int pos[],
+                                unsigned int oldPos, unsigned int newPos,
+                                int skip)
+{
+    const __m512i vox   = _mm512_set1_epi32(POS_ROW(oldPos));
+    const __m512i voy   = _mm512_set1_epi32(POS_COL(oldPos));
+    const __m512i vnx   = _mm512_set1_epi32(POS_ROW(newPos));
+    const __m512i vny   = _mm512_set1_epi32(POS_COL(newPos));
+    const __m512i vskip = _mm512_set1_epi32(skip);
+    const __m512i vlow  = _mm512_set1_epi32(0xffff);
+
+    __m512i acc = _mm512_setzero_si512();
+
+    for (int e = begin; e < end; e += 16) {
+        int left = end - e;
+        __mmask16 live = (left >= 16) ? (__mmask16)0xffff : (__mmask16)((1u << left) - 1);
+
+        __m512i idx = _mm512_maskz_loadu_epi32(live, neighbors + e);
+        __m512i w   = _mm512_maskz_loadu_epi32(live, weights + e);
+
+        live = _mm512_mask_cmpneq_epi32_mask(live, idx, vskip);
+
+        __m512i ps = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), live, idx, pos, 4);
+        __m512i xs = _mm512_maskz_srli_epi32((__mmask16)0xffff, ps, 16);
+        __m512i ys = _mm512_and_si512(ps, vlow);
+
+        __m512i newDist = _mm512_add_epi32(abs512(_mm512_sub_epi32(xs, vnx)),
+                                           abs512(_mm512_sub_epi32(ys, vny)));
+        __m512i oldDist = _mm512_add_epi32(abs512(_mm512_sub_epi32(xs, vox)),
+                                           abs512(_mm512_sub_epi32(ys, voy)));
+
+        __m512i term = _mm512_mullo_epi32(w, _mm512_sub_epi32(newDist, oldDist));
+        acc = _mm512_mask_add_epi32(acc, live, acc, term);
+    }
+
+    alignas(64) int lanes[16];
+    _mm512_store_si512((__m512i*)lanes, acc);
+
+    unsigned int delta = 0;
+    for (int i = 0; i < 16; i++) delta += (unsigned int)lanes[i];
+    return (int)delta;
+}
+
+#endif
+
+// ----------------------------------------------------------
+// Runtime dispatch
+//
+// The table lists every kernel compiled in, portable first; the
+// startup pick is the last one the CPU supports, unless the
+// DELTA_KERNEL environment variable names another (e.g.
+// DELTA_KERNEL=scalar to exercise the portable path in CI).
+// ----------------------------------------------------------
+static const RowDeltaKernel kernelTable[] = {
+    { "scalar", rowDeltaScalar, rowDeltaPackedScalar },
+#ifdef DELTA_SIMD_X86
+    { "avx2",   rowDeltaAVX2,   rowDeltaPackedAVX2 },
+    { "avx512", rowDeltaAVX512, rowDeltaPackedAVX512 },
+#endif
+};
+
+static const int kernelCount = (int)(sizeof(kernelTable) / sizeof(kernelTable[0]));
+
+static int kernelSupported(int k) {
+#ifdef DELTA_SIMD_X86
+    __builtin_cpu_init();
+    if (strcmp(kernelTable[k].name, "avx2") == 0) return __builtin_cpu_supports("avx2");
+    if (strcmp(kernelTable[k].name, "avx512") == 0) return __builtin_cpu_supports("avx512f");
+#endif
+    return 1;
+}
+
+static int findKernel(const char* name) {
+    for (int k = 0; k < kernelCount; k++)
+        if (strcmp(kernelTable[k].name, name) == 0 && kernelSupported(k)) return k;
+    return -1;
+}
+
+static int selectKernel() {
+    const char* forced = getenv("DELTA_KERNEL");
+    if (forced && forced[0]) {
+        int k = findKernel(forced);
+        if (k >= 0) return k;
+        fprintf(stderr, "DELTA_KERNEL=%s is not available here; using the best kernel\n", forced);
+    }
+
+    int best = 0;
+    for (int k = 1; k < kernelCount; k++)
+        if (kernelSupported(k)) best = k;
+    return best;
+}
+
+static const RowDeltaKernel* activeKernel = &kernelTable[selectKernel()];
+
+RowDeltaFn rowDelta2D = activeKernel->rowDelta;
+RowDeltaPackedFn rowDeltaPacked2D = activeKernel->rowDeltaPacked;
+
+int availableRowDeltaKernels(const RowDeltaKernel* out[], int capacity) {
+    int count = 0;
+    for (int k = 0; k < kernelCount; k++)
+        if (kernelSupported(k) && count < capacity) out[count++] = &kernelTable[k];
+    return count;
+}
+
+int useRowDeltaKernel(const char* name) {
+    int k = findKernel(name);
+    if (k < 0) return 0;
+
+    activeKernel = &kernelTable[k];
+    rowDelta2D = activeKernel->rowDelta;
+    rowDeltaPacked2D = activeKernel->rowDeltaPacked;
+    return 1;
+}
+
+const char* rowDeltaKernelName() {
+    return activeKernel->name;
+}
+
+void useScalarRowDelta2D() {
+    useRowDeltaKernel("scalar");
+}
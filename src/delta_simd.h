@@ -0,0 +1,53 @@
+#ifndef DELTA_SIMD_H
+#define DELTA_SIMD_H
+
+// ----------------------------------------------------------
+// Vectorized row kernel for the clique delta cost
+//
+// For one CSR row e in [begin, end) it returns
+//   sum  w[e] * ( dist(new, n) - dist(old, n) )
+// over the neighbors n = neighbors[e] != skip, where dist is the
+// Manhattan distance on mod_x/mod_y. Integer arithmetic, so the
+// AVX2 / AVX-512 versions are bit-identical to the scalar one.
+// ----------------------------------------------------------
+typedef int (*RowDeltaFn)(const int* neighbors, const int* weights,
+                          int begin, int end,
+                          const int mod_x[], const int mod_y[],
+                          int old_x, int old_y, int new_x, int new_y,
+                          int skip);
+
+// Same row kernel over the packed position store (grid.h POS_PACK):
+// one gather per neighbor instead of two
+typedef int (*RowDeltaPackedFn)(const int* neighbors, const int* weights,
+                                int begin, int end,
+                                const unsigned int pos[],
+                                unsigned int oldPos, unsigned int newPos,
+                                int skip);
+
+// One implementation of both row kernels
+struct RowDeltaKernel {
+    const char* name;             // "scalar", "avx2", "avx512"
+    RowDeltaFn rowDelta;
+    RowDeltaPackedFn rowDeltaPacked;
+};
+
+// Active kernels: the best for this CPU, picked once at startup.
+// The environment variable DELTA_KERNEL=<name> overrides the pick
+// (an unavailable name falls back to the best, with a warning).
+extern RowDeltaFn rowDelta2D;
+extern RowDeltaPackedFn rowDeltaPacked2D;
+
+// Name of the active kernel
+const char* rowDeltaKernelName();
+
+// Kernels this CPU can run, portable first (at most capacity).
+// Returns the count written to out.
+int availableRowDeltaKernels(const RowDeltaKernel* out[], int capacity);
+
+// Make the named kernel active. Returns 0 if it is not available.
+int useRowDeltaKernel(const char* name);
+
+// Force the portable kernels (e.g. for A/B checks)
+void useScalarRowDelta2D();
+
+#endif
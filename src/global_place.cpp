@@ -0,0 +1,314 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+#include "global_place.h"
+#include "cost2D.h"
+
+// ----------------------------------------------------------
+// Quadratic system over the movable modules (index i = 0..n-1):
+//   A = L_movable + anchor * I, diagonal = weighted degree + anchor
+// Edges to fixed modules stay on the diagonal and move their
+// position into the right-hand side.
+// ----------------------------------------------------------
+struct QPSystem {
+    const Netlist* net;
+    const int* movable;   // i -> module
+    const int* slot;      // module -> i, -1 if fixed
+    const double* degree; // weighted degree of each movable module
+    int n;
+    double anchor;
+};
+
+// out = A x
+static void multiplyQP(const QPSystem* s, const double x[], double out[]) {
+    const Netlist* net = s->net;
+
+    for (int i = 0; i < s->n; i++) {
+        int m = s->movable[i];
+        double sum = (s->degree[i] + s->anchor) * x[i];
+
+        for (int e = net->offsets[m]; e < net->offsets[m + 1]; e++) {
+            int j = s->slot[net->neighbors[e]];
+            if (j >= 0) sum -= net->edgeWeights[e] * x[j];
+        }
+        out[i] = sum;
+    }
+}
+
+static double dotQP(const double a[], const double b[], int n) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) sum += a[i] * b[i];
+    return sum;
+}
+
+// ----------------------------------------------------------
+// Jacobi-preconditioned CG for A x = b; x holds the start guess.
+// scratch: 4 * n doubles. Returns the iterations used.
+// ----------------------------------------------------------
+static int solveQP(const QPSystem* s, const double b[], double x[], double scratch[]) {
+    int n = s->n;
+    double* r = scratch;
+    double* z = scratch + n;
+    double* p = scratch + 2 * n;
+    double* q = scratch + 3 * n;
+
+    multiplyQP(s, x, q);
+    for (int i = 0; i < n; i++) {
+        r[i] = b[i] - q[i];
+        z[i] = r[i] / (s->degree[i] + s->anchor);
+        p[i] = z[i];
+    }
+
+    double bNorm = sqrt(dotQP(b, b, n));
+    if (bNorm == 0.0) bNorm = 1.0;
+    double rz = dotQP(r, z, n);
+
+    int iter = 0;
+    while (iter < QP_CG_MAX_ITERS && sqrt(dotQP(r, r, n)) > QP_CG_TOLERANCE * bNorm) {
+        multiplyQP(s, p, q);
+        double pq = dotQP(p, q, n);
+        if (pq <= 0.0) break;
+
+        double alpha = rz / pq;
+        for (int i = 0; i < n; i++) {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+            z[i] = r[i] / (s->degree[i] + s->anchor);
+        }
+
+        double rzNext = dotQP(r, z, n);
+        double beta = rzNext / rz;
+        rz = rzNext;
+        for (int i = 0; i < n; i++) p[i] = z[i] + beta * p[i];
+
+        iter++;
+    }
+    return iter;
+}
+
+// Right-hand side: anchor pull plus edges to fixed modules
+static void buildRHS(const QPSystem* s, const int fixedPos[], const double target[], double b[]) {
+    const Netlist* net = s->net;
+
+    for (int i = 0; i < s->n; i++) {
+        int m = s->movable[i];
+        double sum = s->anchor * target[i];
+
+        for (int e = net->offsets[m]; e < net->offsets[m + 1]; e++) {
+            int k = net->neighbors[e];
+            if (s->slot[k] < 0) sum += net->edgeWeights[e] * fixedPos[k];
+        }
+        b[i] = sum;
+    }
+}
+
+// qsort on (coordinate << 32 | index) keys
+static int compareKeys(const void* a, const void* b) {
+    long long ka = *(const long long*)a;
+    long long kb = *(const long long*)b;
+    return (ka > kb) - (ka < kb);
+}
+
+// Sort keys for keys[0..count) entries: coordinate quantized to 30 bits
+static void sortByCoordinate(long long keys[], int count, const double coord[]) {
+    if (count <= 1) return;
+
+    double lo = coord[keys[0] & 0xffffffff], hi = lo;
+    for (int k = 1; k < count; k++) {
+        double v = coord[keys[k] & 0xffffffff];
+        if (v < lo) lo = v;
+        if (v > hi) hi = v;
+    }
+    double scale = (hi > lo) ? (double)(1 << 30) / (hi - lo) : 0.0;
+
+    for (int k = 0; k < count; k++) {
+        long long i = keys[k] & 0xffffffff;
+        long long q = (long long)((coord[i] - lo) * scale);
+        keys[k] = (q << 32) | i;
+    }
+    qsort(keys, count, sizeof(long long), compareKeys);
+}
+
+// ----------------------------------------------------------
+// Order-preserving stripe legalizer
+//
+// Movable modules sorted by row coordinate are dealt to the grid
+// rows in proportion to each row's free cells (cells not held by
+// fixed modules); within a row they are sorted by column and
+// spread evenly over its free cells. Writes legal (row, col) per
+// movable index into lx / ly.
+// ----------------------------------------------------------
+static void legalizeStripes(Grid* g, const char blocked[], int n,
+                            const double px[], const double py[],
+                            long long keys[], int freeCols[], int lx[], int ly[])
+{
+    int freeTotal = 0;
+    for (int c = 0; c < g->rows * g->cols; c++) freeTotal += !blocked[c];
+
+    for (int i = 0; i < n; i++) keys[i] = i;
+    sortByCoordinate(keys, n, px);
+
+    int cumFree = 0;
+    int first = 0;
+
+    for (int r = 0; r < g->rows; r++) {
+        int rowFree = 0;
+        for (int c = 0; c < g->cols; c++)
+            if (!blocked[r * g->cols + c]) freeCols[rowFree++] = c;
+
+        cumFree += rowFree;
+        int last = (int)((long long)n * cumFree / freeTotal);
+        int count = last - first;
+
+        // take this row's share and order it by column
+        long long* slice = keys + first;
+        for (int k = 0; k < count; k++) slice[k] &= 0xffffffff;
+        sortByCoordinate(slice, count, py);
+
+        for (int k = 0; k < count; k++) {
+            int i = (int)(slice[k] & 0xffffffff);
+            lx[i] = r;
+            ly[i] = freeCols[(int)((long long)k * rowFree / count)];
+        }
+        first = last;
+    }
+}
+
+long long quadraticPlacement2D(Grid* g, Netlist* net, int mod_x[], int mod_y[],
+                               int moduleCount, const char isFixed[], int verbose)
+{
+    int* movable = new int[moduleCount];
+    int* slot = new int[moduleCount];
+    int n = 0;
+    for (int m = 0; m < moduleCount; m++) {
+        if (isFixed && isFixed[m]) {
+            slot[m] = -1;
+        } else {
+            slot[m] = n;
+            movable[n++] = m;
+        }
+    }
+
+    long long bestCost = computeCost2D(net, mod_x, mod_y);
+    if (n == 0) {
+        delete[] movable;
+        delete[] slot;
+        return bestCost;
+    }
+
+    // cells held by fixed modules
+    char* blocked = new char[g->rows * g->cols];
+    for (int c = 0; c < g->rows * g->cols; c++) blocked[c] = 0;
+    for (int m = 0; m < moduleCount; m++)
+        if (slot[m] < 0) blocked[mod_x[m] * g->cols + mod_y[m]] = 1;
+
+    double* degree = new double[n];
+    double meanDegree = 0.0;
+    for (int i = 0; i < n; i++) {
+        int m = movable[i];
+        degree[i] = 0.0;
+        for (int e = net->offsets[m]; e < net->offsets[m + 1]; e++)
+            degree[i] += net->edgeWeights[e];
+        meanDegree += degree[i];
+    }
+    meanDegree /= n;
+    if (meanDegree <= 0.0) meanDegree = 1.0;
+
+    double* px = new double[n];
+    double* py = new double[n];
+    double* tx = new double[n];   // anchor targets
+    double* ty = new double[n];
+    double* b = new double[n];
+    double* scratch = new double[4 * n];
+    long long* keys = new long long[n];
+    int* freeCols = new int[g->cols];
+    int* lx = new int[n];
+    int* ly = new int[n];
+
+    // trial placement for costing: fixed modules + legalized movables
+    int* cand_x = new int[moduleCount];
+    int* cand_y = new int[moduleCount];
+    for (int m = 0; m < moduleCount; m++) {
+        cand_x[m] = mod_x[m];
+        cand_y[m] = mod_y[m];
+    }
+
+    // the start placement is the first anchor and the first guess
+    for (int i = 0; i < n; i++) {
+        px[i] = tx[i] = mod_x[movable[i]];
+        py[i] = ty[i] = mod_y[movable[i]];
+    }
+
+    QPSystem sys;
+    sys.net = net;
+    sys.movable = movable;
+    sys.slot = slot;
+    sys.degree = degree;
+    sys.n = n;
+    sys.anchor = QP_ANCHOR_START * meanDegree;
+
+    long long startCost = bestCost;
+    int bestRound = -1;
+
+    for (int round = 0; round < QP_SPREAD_ROUNDS; round++) {
+        buildRHS(&sys, mod_x, tx, b);
+        int itersX = solveQP(&sys, b, px, scratch);
+        buildRHS(&sys, mod_y, ty, b);
+        int itersY = solveQP(&sys, b, py, scratch);
+
+        legalizeStripes(g, blocked, n, px, py, keys, freeCols, lx, ly);
+
+        for (int i = 0; i < n; i++) {
+            cand_x[movable[i]] = lx[i];
+            cand_y[movable[i]] = ly[i];
+            tx[i] = lx[i];
+            ty[i] = ly[i];
+        }
+        long long cost = computeCost2D(net, cand_x, cand_y);
+
+        if (verbose)
+            printf("QP round %d: anchor %.3f, CG %d/%d iterations, legal cost = %lld\n",
+                   round, sys.anchor / meanDegree, itersX, itersY, cost);
+
+        if (cost < bestCost) {
+            bestCost = cost;
+            bestRound = round;
+            for (int i = 0; i < n; i++) {
+                mod_x[movable[i]] = lx[i];
+                mod_y[movable[i]] = ly[i];
+            }
+        }
+
+        sys.anchor *= QP_ANCHOR_GROWTH;
+    }
+
+    // write the best legal placement into the grid
+    if (bestRound >= 0) {
+        clearGrid(g);
+        for (int m = 0; m < moduleCount; m++)
+            placeModuleAt(g, m, mod_x[m], mod_y[m]);
+    }
+
+    if (verbose)
+        printf("Global placement: cost %lld -> %lld (round %d)\n", startCost, bestCost, bestRound);
+
+    delete[] cand_x;
+    delete[] cand_y;
+    delete[] lx;
+    delete[] ly;
+    delete[] freeCols;
+    delete[] keys;
+    delete[] scratch;
+    delete[] b;
+    delete[] tx;
+    delete[] ty;
+    delete[] px;
+    delete[] py;
+    delete[] degree;
+    delete[] blocked;
+    delete[] slot;
+    delete[] movable;
+
+    return bestCost;
+}
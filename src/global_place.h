@@ -0,0 +1,42 @@
+#ifndef GLOBAL_PLACE_H
+#define GLOBAL_PLACE_H
+
+#include "grid.h"
+#include "netlist.h"
+
+// ----------------------------------------------------------
+// Analytical (quadratic) global placement
+//
+// Minimizes the squared clique wirelength sum w_ij * |p_i - p_j|^2
+// over the movable modules, separately for rows and columns: the
+// clique Laplacian restricted to movable modules, plus fixed
+// modules as pinned anchors, gives a sparse SPD system solved by
+// Jacobi-preconditioned conjugate gradients.
+//
+// Without spreading the solution collapses into a cluster, so the
+// solve alternates with a legalizer (SimPL style): modules are cut
+// into grid rows by row coordinate and spread over each row's free
+// cells by column coordinate, keeping their relative order. Each
+// legal placement then pulls the next solve through per-module
+// anchors whose weight grows every round. The first solve is
+// anchored to the start placement.
+//
+// Needs the clique adjacency (buildCliqueAdjacency) and a legal
+// start placement in g / mod_x / mod_y; fixed modules keep their
+// cells. Leaves the best legal placement found in g / mod_x /
+// mod_y and returns its clique cost (computeCost2D).
+// ----------------------------------------------------------
+#define QP_SPREAD_ROUNDS  20      // solve + legalize rounds
+#define QP_ANCHOR_START   0.01    // first anchor weight, relative to the
+                                  // mean weighted degree
+#define QP_ANCHOR_GROWTH  1.3     // anchor weight factor per round
+#define QP_CG_MAX_ITERS   100
+#define QP_CG_TOLERANCE   1e-4    // relative residual
+
+// SAParams::t0Scale for the refinement anneal after global placement
+#define QP_REFINE_T0_SCALE 0.01   // about where plain SA reaches the QP cost
+
+long long quadraticPlacement2D(Grid* g, Netlist* net, int mod_x[], int mod_y[],
+                               int moduleCount, const char isFixed[], int verbose);
+
+#endif
@@ -7,28 +7,122 @@
 // ----------------------------------------------------
 Grid* initGrid(int rows, int cols) {
     if (rows <= 0 || cols <= 0) return NULL;
+    if (rows > GRID_MAX_DIM || cols > GRID_MAX_DIM) return NULL;
 
     Grid* g = new Grid;
     g->rows = rows;
     g->cols = cols;
+    g->modPos = nullptr;
+    g->moduleCount = 0;
 
     // allocate linear array
     g->cells = new int[rows * cols];
+    g->freeSites = new int[rows * cols];
+    g->freeSlot = new int[rows * cols];
 
-    // initialize to EMPTY_CELL
-    for (int i = 0; i < rows * cols; i++) {
-        g->cells[i] = EMPTY_CELL;
-    }
+    // initialize to EMPTY_CELL (every cell free)
+    clearGrid(g);
 
     return g;
 }
 
+// ----------------------------------------------------
+// Free-site index updates (O(1): swap-with-last removal)
+// ----------------------------------------------------
+static inline void markOccupied(Grid* g, int idx) {
+    int slot = g->freeSlot[idx];
+    if (slot < 0) return;
+
+    int last = g->freeSites[--g->freeCount];
+    g->freeSites[slot] = last;
+    g->freeSlot[last] = slot;
+    g->freeSlot[idx] = -1;
+}
+
+static inline void markFree(Grid* g, int idx) {
+    if (g->freeSlot[idx] >= 0) return;
+
+    g->freeSlot[idx] = g->freeCount;
+    g->freeSites[g->freeCount++] = idx;
+}
+
+void rebuildFreeSites(Grid* g) {
+    if (!g) return;
+
+    int n = g->rows * g->cols;
+    g->freeCount = 0;
+    for (int i = 0; i < n; i++) {
+        if (g->cells[i] == EMPTY_CELL) {
+            g->freeSlot[i] = g->freeCount;
+            g->freeSites[g->freeCount++] = i;
+        } else {
+            g->freeSlot[i] = -1;
+        }
+    }
+}
+
+int freeSiteAt(Grid* g, int k) {
+    if (!g || k < 0 || k >= g->freeCount) return -1;
+    return g->freeSites[k];
+}
+
+// ----------------------------------------------------
+// Packed position store: module -> POS_PACK(r, c)
+// ----------------------------------------------------
+void initGridPositions(Grid* g, int moduleCount) {
+    if (!g) return;
+
+    if (!g->modPos || g->moduleCount != moduleCount) {
+        delete[] g->modPos;
+        g->modPos = new unsigned int[moduleCount];
+        g->moduleCount = moduleCount;
+    }
+
+    for (int m = 0; m < moduleCount; m++) g->modPos[m] = POS_NONE;
+
+    for (int r = 0; r < g->rows; r++) {
+        for (int c = 0; c < g->cols; c++) {
+            int m = g->cells[r * g->cols + c];
+            if (m >= 0 && m < moduleCount) g->modPos[m] = POS_PACK(r, c);
+        }
+    }
+}
+
+// record module's packed position (if the store is active)
+static inline void setModPos(Grid* g, int module, unsigned int pos) {
+    if (g->modPos && module >= 0 && module < g->moduleCount)
+        g->modPos[module] = pos;
+}
+
+// ----------------------------------------------------
+// Deep copy (cells + free-site index)
+// ----------------------------------------------------
+Grid* copyGrid(const Grid* g) {
+    if (!g) return NULL;
+
+    Grid* copy = initGrid(g->rows, g->cols);
+    if (!copy) return NULL;
+
+    int n = g->rows * g->cols;
+    for (int i = 0; i < n; i++) {
+        copy->cells[i] = g->cells[i];
+        copy->freeSites[i] = g->freeSites[i];
+        copy->freeSlot[i] = g->freeSlot[i];
+    }
+    copy->freeCount = g->freeCount;
+
+    return copy;
+}
+
 // ----------------------------------------------------
 // Free memory used by grid
 // ----------------------------------------------------
 void freeGrid(Grid* g) {
     if (!g) return;
     if (g->cells) delete[] g->cells;
+    delete[] g->freeSites;
+    delete[] g->freeSlot;
+    delete[] g->modPos;
     delete g;
 }
 
@@ -38,7 +132,16 @@ void freeGrid(Grid* g) {
 void clearGrid(Grid* g) {
     if (!g) return;
     int n = g->rows * g->cols;
-    for (int i = 0; i < n; i++) g->cells[i] = EMPTY_CELL;
+    for (int i = 0; i < n; i++) {
+        g->cells[i] = EMPTY_CELL;
+        g->freeSites[i] = i;
+        g->freeSlot[i] = i;
+    }
+    g->freeCount = n;
+
+    if (g->modPos) {
+        for (int m = 0; m < g->moduleCount; m++) g->modPos[m] = POS_NONE;
+    }
 }
 
 // ----------------------------------------------------
@@ -66,7 +169,11 @@ int getModuleAt(Grid* g, int r, int c) {
 void placeModuleAt(Grid* g, int module, int r, int c) {
     if (!g) return;
     if (r < 0 || r >= g->rows || c < 0 || c >= g->cols) return;
-    g->cells[r * g->cols + c] = module;
+
+    int idx = r * g->cols + c;
+    g->cells[idx] = module;
+    markOccupied(g, idx);
+    setModPos(g, module, POS_PACK(r, c));
 }
 
 // ----------------------------------------------------
@@ -75,7 +182,11 @@ void placeModuleAt(Grid* g, int module, int r, int c) {
 void removeModuleAt(Grid* g, int r, int c) {
     if (!g) return;
     if (r < 0 || r >= g->rows || c < 0 || c >= g->cols) return;
-    g->cells[r * g->cols + c] = EMPTY_CELL;
+
+    int idx = r * g->cols + c;
+    setModPos(g, g->cells[idx], POS_NONE);
+    g->cells[idx] = EMPTY_CELL;
+    markFree(g, idx);
 }
 
 // ----------------------------------------------------
@@ -114,6 +225,9 @@ void swapModules2D(Grid* g, int mod_x[], int mod_y[], int m1, int m2) {
 
     mod_x[m2] = tmpx;
     mod_y[m2] = tmpy;
+
+    setModPos(g, m1, POS_PACK(r2, c2));
+    setModPos(g, m2, POS_PACK(r1, c1));
 }
 
 // ----------------------------------------------------
@@ -132,19 +246,24 @@ void moveModuleTo(Grid* g, int mod_x[], int mod_y[], int module, int new_r, int
     int cur_c = mod_y[module];
 
     // set new cell to module (overwrite)
-    g->cells[new_r * g->cols + new_c] = module;
+    int idxNew = new_r * g->cols + new_c;
+    if (g->cells[idxNew] != module) setModPos(g, g->cells[idxNew], POS_NONE);
+    g->cells[idxNew] = module;
+    markOccupied(g, idxNew);
 
     // clear old cell if it was within bounds and still held this module
     if (cur_r >= 0 && cur_r < g->rows && cur_c >= 0 && cur_c < g->cols) {
         int idxOld = cur_r * g->cols + cur_c;
-        if (g->cells[idxOld] == module) {
+        if (idxOld != idxNew && g->cells[idxOld] == module) {
             g->cells[idxOld] = EMPTY_CELL;
+            markFree(g, idxOld);
         }
     }
 
     // update module arrays
     mod_x[module] = new_r;
     mod_y[module] = new_c;
+    setModPos(g, module, POS_PACK(new_r, new_c));
 }
 
 // ----------------------------------------------------
@@ -4,17 +4,47 @@
 // Special value for empty cell
 #define EMPTY_CELL -1
 
+// Packed module position: row in the high 16 bits, column in the low
+// 16 bits, so one 32-bit load fetches both coordinates
+#define POS_PACK(r, c)  (((unsigned int)(r) << 16) | (unsigned int)(c))
+#define POS_ROW(p)      ((int)((p) >> 16))
+#define POS_COL(p)      ((int)((p) & 0xffffu))
+#define POS_NONE        0xffffffffu   // module not on the grid
+#define GRID_MAX_DIM    0xffff        // rows/cols limit of the packing
+
 // Grid structure
 struct Grid {
     int rows;
     int cols;
     int *cells;      // linear array size rows*cols, cells[r*cols + c] -> module id or EMPTY_CELL
+
+    // Packed module -> position store (nullptr until initGridPositions).
+    // Kept in sync by placeModuleAt / removeModuleAt / swapModules2D /
+    // moveModuleTo and applySwapMove2D.
+    unsigned int *modPos;
+    int moduleCount;
+
+    // Free-site index: freeSites[0 .. freeCount) lists the empty cells
+    // (linear indices, any order); freeSlot[idx] is the position of
+    // cell idx in freeSites, or -1 if the cell is occupied. Kept by
+    // clearGrid / placeModuleAt / removeModuleAt / moveModuleTo.
+    int *freeSites;
+    int *freeSlot;
+    int freeCount;
 };
 
 // Initialize grid structure (allocates memory)
-// Returns pointer to Grid, or nullptr on failure
+// Returns pointer to Grid, or nullptr on failure (or dims > GRID_MAX_DIM)
 Grid* initGrid(int rows, int cols);
 
+// Allocate (if needed) the packed position store for moduleCount
+// modules and rebuild it from the cells
+void initGridPositions(Grid* g, int moduleCount);
+
+// Deep copy of a grid's cells and free-site index
+// (the packed position store is not copied; call initGridPositions)
+Grid* copyGrid(const Grid* g);
+
 // Free grid memory
 void freeGrid(Grid* g);
 
@@ -42,6 +72,13 @@ void swapModules2D(Grid* g, int mod_x[], int mod_y[], int m1, int m2);
 // If target cell occupied, caller decides whether to swap or fail; this function overwrites.
 void moveModuleTo(Grid* g, int mod_x[], int mod_y[], int module, int new_r, int new_c);
 
+// Rebuild the free-site index from the cells (after cells were
+// written directly, e.g. by concurrent tile workers)
+void rebuildFreeSites(Grid* g);
+
+// Linear index of the k-th free cell (k in [0, freeCount)), or -1
+int freeSiteAt(Grid* g, int k);
+
 // Print grid in ASCII format (shows module ids; -1 for empty)
 void printGrid(Grid* g);
 
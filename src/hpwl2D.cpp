@@ -0,0 +1,236 @@
+#include <cstdio>
+#include "netlist.h"
+#include "hpwl2D.h"
+
+// ----------------------------------------------------------
+// Half-perimeter of a box
+// ----------------------------------------------------------
+static inline int boxCost(const NetBox* b) {
+    return (b->xmax - b->xmin) + (b->ymax - b->ymin);
+}
+
+// ----------------------------------------------------------
+// Rescan all pins of net n. If 'moved' is on the net, it is
+// taken to sit at (mx, my) instead of its current position.
+// ----------------------------------------------------------
+static void scanNetBox(Netlist* net, int mod_x[], int mod_y[], int n,
+                       int moved, int mx, int my, NetBox* b)
+{
+    int begin = net->netOffsets[n];
+    int end   = net->netOffsets[n + 1];
+
+    if (begin == end) {
+        b->xmin = b->xmax = b->ymin = b->ymax = 0;
+        b->nxmin = b->nxmax = b->nymin = b->nymax = 0;
+        return;
+    }
+
+    b->xmin = b->ymin = 0x7fffffff;
+    b->xmax = b->ymax = -0x7fffffff;
+    b->nxmin = b->nxmax = b->nymin = b->nymax = 0;
+
+    for (int p = begin; p < end; p++) {
+        int m = net->netPins[p];
+        int x = (m == moved) ? mx : mod_x[m];
+        int y = (m == moved) ? my : mod_y[m];
+
+        if (x < b->xmin) { b->xmin = x; b->nxmin = 1; }
+        else if (x == b->xmin) b->nxmin++;
+
+        if (x > b->xmax) { b->xmax = x; b->nxmax = 1; }
+        else if (x == b->xmax) b->nxmax++;
+
+        if (y < b->ymin) { b->ymin = y; b->nymin = 1; }
+        else if (y == b->ymin) b->nymin++;
+
+        if (y > b->ymax) { b->ymax = y; b->nymax = 1; }
+        else if (y == b->ymax) b->nymax++;
+    }
+}
+
+// ----------------------------------------------------------
+// Update one axis of a box for a pin moving old_c -> new_c.
+// Returns 0 if the only pin on an edge left it (rescan needed).
+// ----------------------------------------------------------
+static inline int updateAxis(int old_c, int new_c,
+                             int* lo, int* nlo, int* hi, int* nhi)
+{
+    if (new_c < old_c) {
+        // leaving the high edge?
+        if (old_c == *hi) {
+            if (*nhi == 1) return 0;
+            (*nhi)--;
+        }
+        // reaching / extending the low edge
+        if (new_c < *lo) { *lo = new_c; *nlo = 1; }
+        else if (new_c == *lo) (*nlo)++;
+    } else if (new_c > old_c) {
+        if (old_c == *lo) {
+            if (*nlo == 1) return 0;
+            (*nlo)--;
+        }
+        if (new_c > *hi) { *hi = new_c; *nhi = 1; }
+        else if (new_c == *hi) (*nhi)++;
+    }
+    return 1;
+}
+
+// ----------------------------------------------------------
+// Allocate state and compute all net boxes
+// ----------------------------------------------------------
+HPWLState2D* initHPWLState2D(Netlist* net, int mod_x[], int mod_y[]) {
+    HPWLState2D* s = new HPWLState2D;
+    s->netCount = net->netCount;
+    s->boxes = new NetBox[net->netCount];
+
+    for (int n = 0; n < net->netCount; n++)
+        scanNetBox(net, mod_x, mod_y, n, -1, 0, 0, &s->boxes[n]);
+
+    // a swap touches at most the nets of two modules
+    int maxNets = 0;
+    for (int m = 0; m < net->moduleCount; m++) {
+        int k = net->modOffsets[m + 1] - net->modOffsets[m];
+        if (k > maxNets) maxNets = k;
+    }
+
+    s->touchedNets  = new int[2 * maxNets + 1];
+    s->touchedBoxes = new NetBox[2 * maxNets + 1];
+    s->touchedCount = 0;
+
+    s->netStamp = new int[net->netCount];
+    for (int n = 0; n < net->netCount; n++) s->netStamp[n] = 0;
+    s->stamp = 0;
+
+    return s;
+}
+
+void freeHPWLState2D(HPWLState2D* s) {
+    if (!s) return;
+    delete[] s->boxes;
+    delete[] s->touchedNets;
+    delete[] s->touchedBoxes;
+    delete[] s->netStamp;
+    delete s;
+}
+
+// ----------------------------------------------------------
+// Full weighted HPWL of a placement
+// ----------------------------------------------------------
+long long computeCostHPWL2D(Netlist* net, int mod_x[], int mod_y[]) {
+    long long total = 0;
+
+    for (int n = 0; n < net->netCount; n++) {
+        NetBox b;
+        scanNetBox(net, mod_x, mod_y, n, -1, 0, 0, &b);
+        total += (long long)net->netWeights[n] * boxCost(&b);
+    }
+
+    return total;
+}
+
+// ----------------------------------------------------------
+// Evaluate module 'module' moving to (new_x, new_y) on every
+// net it belongs to, except nets stamped with 'skipStamp'.
+// New boxes are appended to the touched list.
+// ----------------------------------------------------------
+static long long evalModuleNets(HPWLState2D* s, Netlist* net,
+                                int mod_x[], int mod_y[],
+                                int module, int new_x, int new_y,
+                                int skipStamp)
+{
+    int old_x = mod_x[module];
+    int old_y = mod_y[module];
+
+    long long delta = 0;
+
+    for (int k = net->modOffsets[module]; k < net->modOffsets[module + 1]; k++) {
+        int n = net->modNets[k];
+        if (s->netStamp[n] == skipStamp) continue;
+
+        NetBox* nb = &s->touchedBoxes[s->touchedCount];
+        *nb = s->boxes[n];
+
+        if (!updateAxis(old_x, new_x, &nb->xmin, &nb->nxmin, &nb->xmax, &nb->nxmax) ||
+            !updateAxis(old_y, new_y, &nb->ymin, &nb->nymin, &nb->ymax, &nb->nymax)) {
+            // boundary pin left its edge: rescan this net
+            scanNetBox(net, mod_x, mod_y, n, module, new_x, new_y, nb);
+        }
+
+        delta += net->netWeights[n] * (boxCost(nb) - boxCost(&s->boxes[n]));
+        s->touchedNets[s->touchedCount++] = n;
+    }
+
+    return delta;
+}
+
+// ----------------------------------------------------------
+// Delta HPWL for swapping m1 and m2.
+// Nets holding both modules keep the same box and are skipped.
+// ----------------------------------------------------------
+int computeDeltaHPWLSwap2D(HPWLState2D* s, Netlist* net,
+                           int mod_x[], int mod_y[], int m1, int m2)
+{
+    s->touchedCount = 0;
+    if (m1 == m2) return 0;
+
+    // tag   : net of m1
+    // tag+1 : net of both (unchanged by the swap)
+    s->stamp += 2;
+    int tag = s->stamp;
+
+    for (int k = net->modOffsets[m1]; k < net->modOffsets[m1 + 1]; k++)
+        s->netStamp[net->modNets[k]] = tag;
+
+    for (int k = net->modOffsets[m2]; k < net->modOffsets[m2 + 1]; k++) {
+        int n = net->modNets[k];
+        if (s->netStamp[n] == tag) s->netStamp[n] = tag + 1;
+    }
+
+    int x1 = mod_x[m1], y1 = mod_y[m1];
+    int x2 = mod_x[m2], y2 = mod_y[m2];
+
+    long long delta = 0;
+    delta += evalModuleNets(s, net, mod_x, mod_y, m1, x2, y2, tag + 1);
+    delta += evalModuleNets(s, net, mod_x, mod_y, m2, x1, y1, tag + 1);
+
+    return (int)delta;
+}
+
+// ----------------------------------------------------------
+// Delta HPWL for moving a single module to (new_x, new_y)
+// ----------------------------------------------------------
+int computeDeltaHPWLMove2D(HPWLState2D* s, Netlist* net,
+                           int mod_x[], int mod_y[],
+                           int module, int new_x, int new_y)
+{
+    s->touchedCount = 0;
+    s->stamp += 2;
+
+    return (int)evalModuleNets(s, net, mod_x, mod_y, module, new_x, new_y, s->stamp + 1);
+}
+
+// ----------------------------------------------------------
+// Accept the last evaluated move
+// ----------------------------------------------------------
+void commitHPWLMove2D(HPWLState2D* s) {
+    for (int i = 0; i < s->touchedCount; i++)
+        s->boxes[s->touchedNets[i]] = s->touchedBoxes[i];
+    s->touchedCount = 0;
+}
+
+int touchedNetDeltaHPWL2D(HPWLState2D* s, Netlist* net, int i) {
+    int n = s->touchedNets[i];
+    return net->netWeights[n] * (boxCost(&s->touchedBoxes[i]) - boxCost(&s->boxes[n]));
+}
+
+// ----------------------------------------------------------
+// Sum of the cached weighted HPWL of all nets on a module
+// ----------------------------------------------------------
+int computeModuleLocalHPWL2D(HPWLState2D* s, Netlist* net, int module) {
+    int cost = 0;
+    for (int k = net->modOffsets[module]; k < net->modOffsets[module + 1]; k++) {
+        int n = net->modNets[k];
+        cost += net->netWeights[n] * boxCost(&s->boxes[n]);
+    }
+    return cost;
+}
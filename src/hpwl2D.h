@@ -0,0 +1,61 @@
+#ifndef HPWL2D_H
+#define HPWL2D_H
+
+#include "netlist.h"
+
+// ----------------------------------------------------------
+// Half-perimeter wirelength (HPWL) cost model
+//
+// Each net caches its bounding box plus how many pins sit on
+// each of the four box edges. A move then updates a touched
+// net in O(1) unless the only pin on an edge leaves it, in
+// which case that net is rescanned. Net HPWLs are scaled by
+// the fixed-point net weights.
+// ----------------------------------------------------------
+
+struct NetBox {
+    int xmin, xmax, ymin, ymax;
+    int nxmin, nxmax, nymin, nymax;   // pins on each edge
+};
+
+struct HPWLState2D {
+    int netCount;
+    NetBox* boxes;        // committed box per net
+
+    // Proposed move (filled by computeDeltaHPWL*, applied by commitHPWLMove2D)
+    int* touchedNets;
+    NetBox* touchedBoxes;
+    int touchedCount;
+
+    // net stamps used to spot nets shared by both swapped modules
+    int* netStamp;
+    int stamp;
+};
+
+// Allocate state and compute every net box for the current placement
+HPWLState2D* initHPWLState2D(Netlist* net, int mod_x[], int mod_y[]);
+void freeHPWLState2D(HPWLState2D* s);
+
+// Full HPWL of a placement (no cache)
+long long computeCostHPWL2D(Netlist* net, int mod_x[], int mod_y[]);
+
+// Delta HPWL for swapping m1 and m2 / moving a module to (new_x, new_y).
+// mod_x/mod_y must still hold the pre-move placement. The new boxes
+// of the touched nets are kept until commitHPWLMove2D is called.
+int computeDeltaHPWLSwap2D(HPWLState2D* s, Netlist* net,
+                           int mod_x[], int mod_y[], int m1, int m2);
+int computeDeltaHPWLMove2D(HPWLState2D* s, Netlist* net,
+                           int mod_x[], int mod_y[],
+                           int module, int new_x, int new_y);
+
+// Accept the last evaluated move: store the new boxes of the touched nets
+void commitHPWLMove2D(HPWLState2D* s);
+
+// Weighted HPWL change of the i-th net touched by the last evaluated
+// move (i in [0, touchedCount); call before commitHPWLMove2D)
+int touchedNetDeltaHPWL2D(HPWLState2D* s, Netlist* net, int i);
+
+// Sum of the HPWL of all nets on a module (criticality measure)
+int computeModuleLocalHPWL2D(HPWLState2D* s, Netlist* net, int module);
+
+#endif
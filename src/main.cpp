@@ -1,23 +1,123 @@
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 
 #include "csv_parser.h"
 #include "netlist.h"
+#include "netlist_cache.h"
 #include "grid.h"
 #include "random2D.h"
 #include "cost2D.h"
+#include "delta_simd.h"
+#include "hpwl2D.h"
 #include "sa_timing.h"
+#include "reorder.h"
+#include "rng.h"
+#include "parallel_sa.h"
+#include "tempering.h"
+#include "partitioned_sa.h"
+#include "batch_sa.h"
+#include "global_place.h"
 
-int main() {
+int main(int argc, char** argv) {
 
-    srand((unsigned int)time(NULL));
+    // ---------------------------------------------------------
+    // 0) Command line
+    //    --seed N     reproduce a run (default: clock, printed so
+    //                 it can be replayed)
+    //    --threads K  K independent annealing runs in parallel
+    //                 (0: one per hardware thread, default 1)
+    //    --replicas R parallel tempering with R replicas instead
+    //                 of annealing (0: one per hardware thread)
+    //    --tiles K    anneal one placement with K threads on
+    //                 checkerboard tiles (0: one per hardware thread)
+    //    --batch B    one run, move deltas evaluated speculatively in
+    //                 batches of B (0: default) on --threads workers
+    //    --global     quadratic global placement first, then a short
+    //                 low-temperature anneal (clique cost model)
+    //    --verify-cache  hash-check the binary netlist cache and its
+    //                 CSV source on load
+    //    --reorder none|bfs|rcm  module renumbering for locality
+    //                 (default rcm, reorder.h)
+    //    --cost clique|hpwl  clique Manhattan sum (default) or
+    //                 half-perimeter wirelength (sa_timing.h)
+    //    DELTA_KERNEL=scalar|avx2|avx512 in the environment forces
+    //    the delta row kernel (delta_simd.h)
+    // ---------------------------------------------------------
+    unsigned long long seed = (unsigned long long)time(NULL);
+    int saRuns = 1;
+    int replicas = -1;      // -1: no tempering
+    int tileThreads = -1;   // -1: no tile partitioning
+    int batchSize = -1;     // -1: no speculative batches
+    int globalPlace = 0;
+    int verifyCache = 0;
+    int reorderMode = REORDER_RCM;
+    int costModel = COST_CLIQUE;
+    int badArgs = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            saRuns = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--replicas") == 0 && i + 1 < argc) {
+            replicas = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tiles") == 0 && i + 1 < argc) {
+            tileThreads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batchSize = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--global") == 0) {
+            globalPlace = 1;
+        } else if (strcmp(argv[i], "--verify-cache") == 0) {
+            verifyCache = 1;
+        } else if (strcmp(argv[i], "--reorder") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "none") == 0)     reorderMode = REORDER_NONE;
+            else if (strcmp(argv[i], "bfs") == 0) reorderMode = REORDER_BFS;
+            else if (strcmp(argv[i], "rcm") == 0) reorderMode = REORDER_RCM;
+            else {
+                printf("Unknown --reorder mode: %s (none, bfs or rcm)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--cost") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "clique") == 0)    costModel = COST_CLIQUE;
+            else if (strcmp(argv[i], "hpwl") == 0) costModel = COST_HPWL;
+            else {
+                printf("Unknown --cost model: %s (clique or hpwl)\n", argv[i]);
+                return 1;
+            }
+        } else {
+            badArgs = 1;
+            break;
+        }
+    }
+
+    // --replicas, --tiles and --batch each pick a different engine
+    if (!badArgs && (replicas >= 0) + (tileThreads >= 0) + (batchSize >= 0) > 1) {
+        printf("Use only one of --replicas, --tiles and --batch\n");
+        badArgs = 1;
+    }
+
+    if (badArgs) {
+        printf("Usage: %s [--seed N] [--global] [--verify-cache] [--reorder none|bfs|rcm] [--cost clique|hpwl] [--threads K] [--replicas R | --tiles K | --batch B]\n", argv[0]);
+        return 1;
+    }
+
+    if (globalPlace && costModel != COST_CLIQUE) {
+        printf("--global needs the clique cost model\n");
+        return 1;
+    }
+
+    setRandomSeed(seed);
+    printf("Seed: %llu\n", seed);
 
     // ---------------------------------------------------------
-    // 1) Initialize adjacency memory pool
-    //    (adjust capacity if you know approx edges)
+    // 1) Initialize netlist memory arena
+    //    (grows in chunks as needed; 0 = default chunk size)
     // ---------------------------------------------------------
-    initNodePool(1000000);   // example: 1 million adjacency nodes
+    initNodePool(0);
 
     // ---------------------------------------------------------
     // 2) Load CSV netlist
@@ -25,7 +125,8 @@ int main() {
     int moduleCount = 0;
     const char* filename = "tests/nets_5k.csv";
 
-    Netlist* net = parseCSVNetlist(filename, &moduleCount);
+    // reuses "<filename>.bin" while it matches the CSV (size + mtime)
+    Netlist* net = loadNetlistCached(filename, &moduleCount, verifyCache);
     if (!net) {
         printf("Failed to parse netlist file: %s\n", filename);
         freeNodePool();
@@ -34,8 +135,33 @@ int main() {
 
     printf("Netlist loaded. Module count = %d\n", moduleCount);
 
+    // Optional locality renumbering (--reorder).
+    // order[newID] = original ID, used to report results in B_xxxx naming.
+
+    int* order = new int[moduleCount];
+    int* rank  = new int[moduleCount];
+    computeModuleOrder(net, reorderMode, order, rank);
+
+    if (reorderMode != REORDER_NONE) {
+        Netlist* reordered = permuteNetlist(net, rank);
+        freeNetlist(net);
+        net = reordered;
+    }
+
+    // Clique cost model needs the expanded adjacency
+    if (costModel == COST_CLIQUE && !buildCliqueAdjacency(net)) {
+        freeNetlist(net);
+        delete[] order;
+        delete[] rank;
+        freeNodePool();
+        return 1;
+    }
+
     printNetlistStats(net);
-    checkNetlistIntegrity(net);
+    printNodePoolStats();
+    printf("Delta kernel: %s\n", rowDeltaKernelName());
+    if (costModel == COST_CLIQUE)
+        checkNetlistIntegrity(net);
 
     // ---------------------------------------------------------
     // 3) Create FPGA grid (must have enough cells)
@@ -46,6 +172,8 @@ int main() {
     if (rows * cols < moduleCount) {
         printf("ERROR: Grid too small for %d modules (%d cells only)\n",
                moduleCount, rows * cols);
+        delete[] order;
+        delete[] rank;
         freeNetlist(net);
         freeNodePool();
         return 1;
@@ -54,6 +182,8 @@ int main() {
     Grid* g = initGrid(rows, cols);
     if (!g) {
         printf("ERROR: Could not allocate grid.\n");
+        delete[] order;
+        delete[] rank;
         freeNetlist(net);
         freeNodePool();
         return 1;
@@ -61,46 +191,107 @@ int main() {
 
     // ---------------------------------------------------------
     // 4) Allocate placement coordinate arrays
+    //    (seeded from the blocks file if it can be read)
     // ---------------------------------------------------------
     int* mod_x = new int[moduleCount];
     int* mod_y = new int[moduleCount];
+    char* isFixed = new char[moduleCount];
+
+    const char* blocksFile = "tests/blocks_5k.csv";
+    int blockCount = parseCSVBlocks(blocksFile, moduleCount, mod_x, mod_y, isFixed);
 
-    for (int i = 0; i < moduleCount; i++) {
-        mod_x[i] = -1;
-        mod_y[i] = -1;
+    if (blockCount < 0) {
+        for (int i = 0; i < moduleCount; i++) {
+            mod_x[i] = -1;
+            mod_y[i] = -1;
+            isFixed[i] = 0;
+        }
     }
 
     // ---------------------------------------------------------
-    // 5) Random initial placement
+    // 5) Initial placement: keep usable initial coordinates,
+    //    scatter everything else at random
     // ---------------------------------------------------------
     clearGrid(g);
-    randomInitialPlacement2D(g, moduleCount, mod_x, mod_y);
+    int warmStarted = warmStartPlacement2D(g, moduleCount, mod_x, mod_y, isFixed);
+
+    int fixedCount = 0;
+    for (int i = 0; i < moduleCount; i++) fixedCount += isFixed[i];
+
+    printf("Blocks read: %d, warm-started: %d, fixed: %d\n",
+           blockCount, warmStarted, fixedCount);
 
     printf("\nInitial placement grid:\n");
     printGrid(g);
 
-    int initialCost = computeCost2D(net, mod_x, mod_y);
-    printf("Initial 2D cost = %d\n", initialCost);
+    // Blocks and placement use original IDs up to here; switch them
+    // to the renumbered IDs of the netlist
+    if (reorderMode != REORDER_NONE) {
+        permuteModuleInts(mod_x, order, moduleCount);
+        permuteModuleInts(mod_y, order, moduleCount);
+        permuteModuleChars(isFixed, order, moduleCount);
+        relabelGrid(g, rank);
+    }
+
+    long long initialCost = (costModel == COST_HPWL)
+        ? computeCostHPWL2D(net, mod_x, mod_y)
+        : computeCost2D(net, mod_x, mod_y);
+    // costs are fixed point (WEIGHT_ONE == weight 1.0)
+    printf("Initial 2D cost = %lld (%.2f)\n", initialCost, (double)initialCost / WEIGHT_ONE);
 
     // ---------------------------------------------------------
     // 6) Run Simulated Annealing
     // ---------------------------------------------------------
-    simulatedAnnealing2D(g, net, mod_x, mod_y, moduleCount);
+    SAParams params;
+    initSAParams(&params);
+    params.costModel = costModel;
+    params.isFixed = isFixed;
+    params.moveGen = MOVE_WINDOW;   // range-limited swaps (MOVE_GLOBAL: whole design)
+    params.emptyMoveRate = 0.1;     // relocations into free cells
+
+    // Analytical start: the anneal only has to refine it
+    if (globalPlace) {
+        quadraticPlacement2D(g, net, mod_x, mod_y, moduleCount, isFixed, 1);
+        params.t0Scale = QP_REFINE_T0_SCALE;
+    }
+
+    if (tileThreads >= 0)
+        partitionedAnnealing2D(g, net, mod_x, mod_y, moduleCount, &params, tileThreads, 0);
+    else if (batchSize >= 0)
+        speculativeAnnealing2D(g, net, mod_x, mod_y, moduleCount, &params, saRuns, batchSize);
+    else if (replicas >= 0)
+        parallelTempering2D(g, net, mod_x, mod_y, moduleCount, &params, replicas, 0);
+    else if (saRuns == 1)
+        simulatedAnnealing2D(g, net, mod_x, mod_y, moduleCount, &params);
+    else
+        parallelSimulatedAnnealing2D(g, net, mod_x, mod_y, moduleCount, &params, saRuns);
 
     // ---------------------------------------------------------
-    // 7) Show final placement
+    // 7) Show final placement (in original module IDs)
     // ---------------------------------------------------------
+    long long finalCost = (costModel == COST_HPWL)
+        ? computeCostHPWL2D(net, mod_x, mod_y)
+        : computeCost2D(net, mod_x, mod_y);
+
+    if (reorderMode != REORDER_NONE) {
+        unpermuteModuleInts(mod_x, order, moduleCount);
+        unpermuteModuleInts(mod_y, order, moduleCount);
+        relabelGrid(g, order);
+    }
+
     printf("\nFinal placement grid:\n");
     printGrid(g);
 
-    int finalCost = computeCost2D(net, mod_x, mod_y);
-    printf("Final 2D cost = %d\n", finalCost);
+    printf("Final 2D cost = %lld (%.2f)\n", finalCost, (double)finalCost / WEIGHT_ONE);
 
     // ---------------------------------------------------------
     // 8) Cleanup
     // ---------------------------------------------------------
     delete[] mod_x;
     delete[] mod_y;
+    delete[] isFixed;
+    delete[] order;
+    delete[] rank;
 
     freeGrid(g);
     freeNetlist(net);
@@ -0,0 +1,96 @@
+#include <cstdio>
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ----------------------------------------------------------
+// Map a whole file read-only
+// ----------------------------------------------------------
+int mapFile(const char* filename, MappedFile* mf) {
+    mf->data = nullptr;
+    mf->size = 0;
+    mf->fd = -1;
+    mf->fileHandle = nullptr;
+    mf->mapHandle = nullptr;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return 0;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return 0;
+    }
+
+    mf->fileHandle = file;
+    mf->size = (size_t)size.QuadPart;
+    if (mf->size == 0) return 1;
+
+    HANDLE map = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!map) {
+        unmapFile(mf);
+        return 0;
+    }
+    mf->mapHandle = map;
+
+    mf->data = (const char*)MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+    if (!mf->data) {
+        unmapFile(mf);
+        return 0;
+    }
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return 0;
+    }
+
+    mf->fd = fd;
+    mf->size = (size_t)st.st_size;
+    if (mf->size == 0) return 1;
+
+    void* p = mmap(nullptr, mf->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+        unmapFile(mf);
+        return 0;
+    }
+    mf->data = (const char*)p;
+
+    // the parsers stream through the file front to back
+    madvise(p, mf->size, MADV_SEQUENTIAL);
+#endif
+
+    return 1;
+}
+
+// ----------------------------------------------------------
+// Unmap and close
+// ----------------------------------------------------------
+void unmapFile(MappedFile* mf) {
+#ifdef _WIN32
+    if (mf->data) UnmapViewOfFile(mf->data);
+    if (mf->mapHandle) CloseHandle((HANDLE)mf->mapHandle);
+    if (mf->fileHandle) CloseHandle((HANDLE)mf->fileHandle);
+#else
+    if (mf->data) munmap((void*)mf->data, mf->size);
+    if (mf->fd >= 0) close(mf->fd);
+#endif
+
+    mf->data = nullptr;
+    mf->size = 0;
+    mf->fd = -1;
+    mf->fileHandle = nullptr;
+    mf->mapHandle = nullptr;
+}
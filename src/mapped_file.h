@@ -0,0 +1,26 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+
+// ----------------------------------------------------------
+// Read-only memory-mapped file
+// (mmap on POSIX, MapViewOfFile on Windows)
+// ----------------------------------------------------------
+struct MappedFile {
+    const char* data;   // mapped bytes (nullptr for an empty file)
+    size_t size;        // file size in bytes
+
+    // platform handles
+    int fd;
+    void* fileHandle;
+    void* mapHandle;
+};
+
+// Map a whole file read-only. Returns 1 on success, 0 on failure.
+int mapFile(const char* filename, MappedFile* mf);
+
+// Unmap and close
+void unmapFile(MappedFile* mf);
+
+#endif
@@ -1,15 +1,14 @@
-#include <cstdlib>
-#include <ctime>
 #include <cstdio>
 
 #include "move2D.h"
 #include "grid.h"
+#include "rng.h"
 
 // ------------------------------------------------------
-// Random integer in [min, max]
+// Random integer in [min, max] (calling thread's stream)
 // ------------------------------------------------------
 int randInt2D(int min, int max) {
-    return min + (rand() % (max - min + 1));
+    return rngRange(threadRng(), min, max);
 }
 
 // ------------------------------------------------------
@@ -33,6 +32,69 @@ void generateRandomModulePair(int moduleCount, int* m1, int* m2) {
     *m2 = b;
 }
 
+// ------------------------------------------------------
+// Compact list of movable modules (fixed ones are skipped)
+// ------------------------------------------------------
+int buildMovableList(const char isFixed[], int moduleCount, int movable[]) {
+    int count = 0;
+    for (int m = 0; m < moduleCount; m++) {
+        if (!isFixed || !isFixed[m])
+            movable[count++] = m;
+    }
+    return count;
+}
+
+// ------------------------------------------------------
+// Randomly choose two distinct movable modules
+// ------------------------------------------------------
+void generateRandomMovablePair(const int movable[], int movableCount, int* m1, int* m2) {
+    int a, b;
+    generateRandomModulePair(movableCount, &a, &b);
+
+    *m1 = movable[a];
+    *m2 = movable[b];
+}
+
+// ------------------------------------------------------
+// Range-limited partner around m1's cell
+// ------------------------------------------------------
+int generateWindowPartner2D(Grid* g, const int mod_x[], const int mod_y[],
+                            const char isFixed[], int m1, int rlim, int* m2)
+{
+    int r = mod_x[m1];
+    int c = mod_y[m1];
+
+    int rLo = r - rlim < 0 ? 0 : r - rlim;
+    int rHi = r + rlim >= g->rows ? g->rows - 1 : r + rlim;
+    int cLo = c - rlim < 0 ? 0 : c - rlim;
+    int cHi = c + rlim >= g->cols ? g->cols - 1 : c + rlim;
+
+    for (int t = 0; t < WINDOW_MAX_TRIES; t++) {
+        int tr = randInt2D(rLo, rHi);
+        int tc = randInt2D(cLo, cHi);
+
+        int m = g->cells[tr * g->cols + tc];
+        if (m == EMPTY_CELL || m == m1) continue;
+        if (isFixed && isFixed[m]) continue;
+
+        *m2 = m;
+        return 1;
+    }
+    return 0;
+}
+
+// ------------------------------------------------------
+// Adapt the window toward WINDOW_TARGET_ACCEPT acceptance
+// ------------------------------------------------------
+double updateWindowLimit2D(Grid* g, double rlim, double acceptRate) {
+    double maxLim = (g->rows > g->cols) ? g->rows : g->cols;
+
+    rlim *= 1.0 - WINDOW_TARGET_ACCEPT + acceptRate;
+    if (rlim < 1.0) rlim = 1.0;
+    if (rlim > maxLim) rlim = maxLim;
+    return rlim;
+}
+
 // ------------------------------------------------------
 // Apply a swap move using Grid + mod_x/mod_y arrays
 // This is a *real* move (it changes the placement).
@@ -68,20 +130,55 @@ void applySwapMove2D(Grid* g, int mod_x[], int mod_y[], int m1, int m2) {
 
     mod_x[m2] = tmpx;
     mod_y[m2] = tmpy;
+
+    // packed position store
+    if (g->modPos) {
+        g->modPos[m1] = POS_PACK(r2, c2);
+        g->modPos[m2] = POS_PACK(r1, c1);
+    }
 }
 
 // ------------------------------------------------------
 // Count how many cells in the grid are EMPTY_CELL
+// (read from the grid's free-site index)
 // ------------------------------------------------------
 int countEmptyCells(Grid* g) {
     if (!g) return 0;
-    int totalCells = g->rows * g->cols;
-    int count = 0;
-    for (int i = 0; i < totalCells; i++) {
-        if (g->cells[i] == EMPTY_CELL)
-            count++;
+    return g->freeCount;
+}
+
+// ------------------------------------------------------
+// Uniform random empty cell, O(1) via the free-site index
+// ------------------------------------------------------
+int sampleFreeSite2D(Grid* g, int* target_r, int* target_c) {
+    if (!g || g->freeCount == 0) return 0;
+
+    int idx = freeSiteAt(g, randInt2D(0, g->freeCount - 1));
+    *target_r = idx / g->cols;
+    *target_c = idx % g->cols;
+    return 1;
+}
+
+// ------------------------------------------------------
+// Random empty cell within rlim rows/cols of (r, c)
+// ------------------------------------------------------
+int sampleFreeSiteNear2D(Grid* g, int r, int c, int rlim, int* target_r, int* target_c) {
+    int rLo = r - rlim < 0 ? 0 : r - rlim;
+    int rHi = r + rlim >= g->rows ? g->rows - 1 : r + rlim;
+    int cLo = c - rlim < 0 ? 0 : c - rlim;
+    int cHi = c + rlim >= g->cols ? g->cols - 1 : c + rlim;
+
+    for (int t = 0; t < WINDOW_MAX_TRIES; t++) {
+        int tr = randInt2D(rLo, rHi);
+        int tc = randInt2D(cLo, cHi);
+
+        if (g->cells[tr * g->cols + tc] == EMPTY_CELL) {
+            *target_r = tr;
+            *target_c = tc;
+            return 1;
+        }
     }
-    return count;
+    return 0;
 }
 
 // ------------------------------------------------------
@@ -105,8 +202,7 @@ int generateRandomMoveToEmptyCell(Grid* g,
 {
     if (!g) return 0;
 
-    int emptyCount = countEmptyCells(g);
-    if (emptyCount == 0) {
+    if (g->freeCount == 0) {
         // No empty cells, cannot perform this type of move
         return 0;
     }
@@ -114,29 +210,6 @@ int generateRandomMoveToEmptyCell(Grid* g,
     // Choose a random module
     *module = randInt2D(0, moduleCount - 1);
 
-    // Choose a random empty cell:
-    // 1) randomly select a target index in [0, emptyCount-1]
-    // 2) scan grid to locate that-th empty cell
-    int targetIndex = randInt2D(0, emptyCount - 1);
-
-    int currentEmptyIdx = 0;
-    int totalCells = g->rows * g->cols;
-
-    for (int idx = 0; idx < totalCells; idx++) {
-        if (g->cells[idx] == EMPTY_CELL) {
-            if (currentEmptyIdx == targetIndex) {
-                // decode (r,c) from idx
-                int r = idx / g->cols;
-                int c = idx % g->cols;
-
-                *target_r = r;
-                *target_c = c;
-                return 1;
-            }
-            currentEmptyIdx++;
-        }
-    }
-
-    // Should not reach here
-    return 0;
+    // Choose a random empty cell straight from the free-site index
+    return sampleFreeSite2D(g, target_r, target_c);
 }
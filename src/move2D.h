@@ -10,6 +10,27 @@ int randInt2D(int min, int max);
 // and output them as m1, m2. The grid is *not* modified here.
 void generateRandomModulePair(int moduleCount, int* m1, int* m2);
 
+// Collect the IDs of all movable modules (isFixed[m] == 0) into
+// movable[] (size moduleCount). isFixed == nullptr: all movable.
+// Returns the number of movable modules.
+int buildMovableList(const char isFixed[], int moduleCount, int movable[]);
+
+// Randomly choose two distinct modules from the compact movable list
+void generateRandomMovablePair(const int movable[], int movableCount, int* m1, int* m2);
+
+// Range-limited partner: pick a random cell within rlim rows/cols of
+// module m1's cell (clipped to the grid) and return its occupant in m2.
+// Empty cells, fixed occupants and m1 itself are redrawn up to
+// WINDOW_MAX_TRIES times. Returns 1 on success, 0 if no partner was found.
+#define WINDOW_MAX_TRIES 8
+int generateWindowPartner2D(Grid* g, const int mod_x[], const int mod_y[],
+                            const char isFixed[], int m1, int rlim, int* m2);
+
+// VPR-style window update: scale rlim by (1 - target + acceptRate),
+// clipped to [1, max(rows, cols)]
+#define WINDOW_TARGET_ACCEPT 0.44
+double updateWindowLimit2D(Grid* g, double rlim, double acceptRate);
+
 // Apply a 2D swap between two modules using grid + mod_x/mod_y
 void applySwapMove2D(Grid* g, int mod_x[], int mod_y[], int m1, int m2);
 
@@ -23,7 +44,14 @@ int generateRandomMoveToEmptyCell(Grid* g,
                                   int* target_r,
                                   int* target_c);
 
-// Optional: helper – count empty cells
+// Optional: helper – count empty cells (O(1), free-site index)
 int countEmptyCells(Grid* g);
 
+// Uniform random empty cell (O(1)). Returns 0 if the grid is full.
+int sampleFreeSite2D(Grid* g, int* target_r, int* target_c);
+
+// Random empty cell within rlim rows/cols of (r, c); up to
+// WINDOW_MAX_TRIES draws. Returns 0 if none was hit.
+int sampleFreeSiteNear2D(Grid* g, int r, int c, int rlim, int* target_r, int* target_c);
+
 #endif
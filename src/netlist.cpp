@@ -1,41 +1,231 @@
 #include <cstdio>
 #include <cstdlib>
+#include <climits>
 #include "netlist.h"
+#include "mapped_file.h"
 
 // ------------------------------------------------------------
-// Allocate empty netlist with adjacency lists initialized to NULL
+// Build the hypergraph: copy net -> pins into the arena, then
+// derive module -> nets with a count-then-fill pass.
+// Pins with invalid IDs are dropped.
 // ------------------------------------------------------------
-Netlist* initNetlist(int moduleCount) {
+Netlist* initNetlistFromNets(int moduleCount, int netCount,
+                             const int* netOffsets, const int* netPins,
+                             const int* netWeights)
+{
     Netlist* net = new Netlist;
     net->moduleCount = moduleCount;
-    net->adj = new Node*[moduleCount];
+    net->netCount = netCount;
+    net->offsets = nullptr;
+    net->neighbors = nullptr;
+    net->edgeWeights = nullptr;
+    net->mapping = nullptr;
+
+    // ---- net -> pins (a module listed twice on a net keeps one pin) ----
+    // lastNet[m]: last net that took module m as a pin
+    int* lastNet = new int[moduleCount];
+    for (int m = 0; m < moduleCount; m++) lastNet[m] = -1;
+
+    int pinCount = 0;
+    for (int n = 0; n < netCount; n++) {
+        for (int p = netOffsets[n]; p < netOffsets[n + 1]; p++) {
+            int id = netPins[p];
+            if (id < 0 || id >= moduleCount || lastNet[id] == n) continue;
+            lastNet[id] = n;
+            pinCount++;
+        }
+    }
+
+    net->netOffsets = allocNodes(netCount + 1);
+    net->netPins    = allocNodes(pinCount);
+
+    for (int m = 0; m < moduleCount; m++) lastNet[m] = -1;
+
+    int k = 0;
+    for (int n = 0; n < netCount; n++) {
+        net->netOffsets[n] = k;
+        for (int p = netOffsets[n]; p < netOffsets[n + 1]; p++) {
+            int id = netPins[p];
+            if (id < 0 || id >= moduleCount || lastNet[id] == n) continue;
+            lastNet[id] = n;
+            net->netPins[k++] = id;
+        }
+    }
+    net->netOffsets[netCount] = k;
+    delete[] lastNet;
 
-    for (int i = 0; i < moduleCount; i++)
-        net->adj[i] = nullptr;
+    // ---- net weights ----
+    net->netWeights = allocNodes(netCount);
+    for (int n = 0; n < netCount; n++)
+        net->netWeights[n] = netWeights ? netWeights[n] : WEIGHT_ONE;
+
+    // ---- module -> nets: count ----
+    net->modOffsets = allocNodes(moduleCount + 1);
+    for (int m = 0; m <= moduleCount; m++)
+        net->modOffsets[m] = 0;
+
+    for (int p = 0; p < pinCount; p++)
+        net->modOffsets[net->netPins[p] + 1]++;
+
+    for (int m = 0; m < moduleCount; m++)
+        net->modOffsets[m + 1] += net->modOffsets[m];
+
+    // ---- module -> nets: fill ----
+    net->modNets = allocNodes(pinCount);
+
+    int* cursor = new int[moduleCount];
+    for (int m = 0; m < moduleCount; m++)
+        cursor[m] = net->modOffsets[m];
+
+    for (int n = 0; n < netCount; n++) {
+        for (int p = net->netOffsets[n]; p < net->netOffsets[n + 1]; p++)
+            net->modNets[cursor[net->netPins[p]]++] = n;
+    }
 
+    delete[] cursor;
     return net;
 }
 
 // ------------------------------------------------------------
-// Add edge a → b (directed). Caller must add both directions if needed.
+// Collapse parallel edges: two modules sharing several nets get
+// one neighbor entry whose weight is the sum of the net weights.
+// Self-loops have zero length and are dropped. Rows only shrink, so compaction is in place.
 // ------------------------------------------------------------
-void addEdge(Netlist* net, int a, int b) {
-    if (!net) return;
-    if (a < 0 || a >= net->moduleCount) return;
-    if (b < 0 || b >= net->moduleCount) return;
+static void mergeParallelEdges(Netlist* net) {
+    int moduleCount = net->moduleCount;
+
+    // seen[b] == m : b already has an entry in row m, at pos[b]
+    int* seen = new int[moduleCount];
+    int* pos  = new int[moduleCount];
+    for (int i = 0; i < moduleCount; i++) seen[i] = -1;
+
+    int write = 0;
+    for (int m = 0; m < moduleCount; m++) {
+        int begin = net->offsets[m];
+        int end   = net->offsets[m + 1];
+
+        net->offsets[m] = write;
+
+        for (int e = begin; e < end; e++) {
+            int b = net->neighbors[e];
+            int w = net->edgeWeights[e];
+
+            if (b == m) continue;
+
+            if (seen[b] == m) {
+                net->edgeWeights[pos[b]] += w;
+            } else {
+                seen[b] = m;
+                pos[b] = write;
+                net->neighbors[write]   = b;
+                net->edgeWeights[write] = w;
+                write++;
+            }
+        }
+    }
+    net->offsets[moduleCount] = write;
 
-    Node* n = allocNode();
-    n->module = b;
-    n->next = net->adj[a];
-    net->adj[a] = n;
+    delete[] seen;
+    delete[] pos;
 }
 
 // ------------------------------------------------------------
-// Free entire adjacency list
+// Derive clique adjacency (CSR) from the hypergraph.
+//
+// Pass 1 counts the degree of every module, a prefix sum turns
+// the counts into offsets, and pass 2 fills the neighbor array.
+// Parallel edges are then merged into weighted multi-edges.
+// Counts are kept in long long: the pre-merge size grows with
+// the square of the fanout.
+// ------------------------------------------------------------
+int buildCliqueAdjacency(Netlist* net) {
+    if (!net) return 0;
+    if (net->offsets) return 1;
+
+    int moduleCount = net->moduleCount;
+
+    // ---- pass 1: count degrees ----
+    long long* degree = new long long[moduleCount];
+    for (int m = 0; m < moduleCount; m++)
+        degree[m] = 0;
+
+    int skipped = 0;
+    for (int n = 0; n < net->netCount; n++) {
+        int fanout = netFanout(net, n);
+        if (fanout > CLIQUE_MAX_FANOUT) {
+            skipped++;
+            continue;
+        }
+
+        for (int p = net->netOffsets[n]; p < net->netOffsets[n + 1]; p++)
+            degree[net->netPins[p]] += fanout - 1;
+    }
+
+    long long total = 0;
+    for (int m = 0; m < moduleCount; m++)
+        total += degree[m];
+
+    if (total > INT_MAX) {
+        printf("Error: clique expansion needs %lld entries (limit %d); "
+               "use the HPWL cost model.\n", total, INT_MAX);
+        delete[] degree;
+        return 0;
+    }
+    if (skipped)
+        printf("Clique adjacency: %d net(s) with fanout > %d left out\n",
+               skipped, CLIQUE_MAX_FANOUT);
+
+    // ---- prefix sum: counts -> offsets ----
+    net->offsets = allocNodes(moduleCount + 1);
+    net->offsets[0] = 0;
+    for (int m = 0; m < moduleCount; m++)
+        net->offsets[m + 1] = net->offsets[m] + (int)degree[m];
+    delete[] degree;
+
+    net->neighbors   = allocNodes(net->offsets[moduleCount]);
+    net->edgeWeights = allocNodes(net->offsets[moduleCount]);
+
+    // ---- pass 2: fill ----
+    int* cursor = new int[moduleCount];
+    for (int m = 0; m < moduleCount; m++)
+        cursor[m] = net->offsets[m];
+
+    for (int n = 0; n < net->netCount; n++) {
+        int begin = net->netOffsets[n];
+        int end   = net->netOffsets[n + 1];
+        int w     = net->netWeights[n];
+        if (end - begin > CLIQUE_MAX_FANOUT) continue;
+
+        for (int i = begin; i < end; i++) {
+            int a = net->netPins[i];
+
+            for (int j = i + 1; j < end; j++) {
+                int b = net->netPins[j];
+
+                net->edgeWeights[cursor[a]] = w;
+                net->neighbors[cursor[a]++] = b;
+                net->edgeWeights[cursor[b]] = w;
+                net->neighbors[cursor[b]++] = a;
+            }
+        }
+    }
+
+    delete[] cursor;
+
+    mergeParallelEdges(net);
+    return 1;
+}
+
+// ------------------------------------------------------------
+// Free netlist (array storage belongs to the node arena,
+// or to the cache mapping)
 // ------------------------------------------------------------
 void freeNetlist(Netlist* net) {
     if (!net) return;
-    delete[] net->adj;
+    if (net->mapping) {
+        unmapFile(net->mapping);
+        delete net->mapping;
+    }
     delete net;
 }
 
@@ -46,16 +236,23 @@ void freeNetlist(Netlist* net) {
 void printNetlist(Netlist* net) {
     if (!net) return;
 
-    printf("\n=== Netlist Adjacency ===\n");
-    for (int i = 0; i < net->moduleCount; i++) {
-        printf("%d: ", i);
-        Node* curr = net->adj[i];
-        while (curr) {
-            printf("%d ", curr->module);
-            curr = curr->next;
-        }
+    printf("\n=== Netlist Hypergraph ===\n");
+    for (int n = 0; n < net->netCount; n++) {
+        printf("net %d (w=%.2f): ", n, (double)net->netWeights[n] / WEIGHT_ONE);
+        for (int p = net->netOffsets[n]; p < net->netOffsets[n + 1]; p++)
+            printf("%d ", net->netPins[p]);
         printf("\n");
     }
+
+    if (net->offsets) {
+        printf("\n=== Netlist Adjacency ===\n");
+        for (int i = 0; i < net->moduleCount; i++) {
+            printf("%d: ", i);
+            for (int e = net->offsets[i]; e < net->offsets[i + 1]; e++)
+                printf("%d ", net->neighbors[e]);
+            printf("\n");
+        }
+    }
     printf("=========================\n");
 }
 
@@ -69,6 +266,29 @@ void printNetlistStats(Netlist* net) {
     }
 
     int moduleCount = net->moduleCount;
+    int pinCount = net->netOffsets[net->netCount];
+    int maxFanout = 0;
+
+    for (int n = 0; n < net->netCount; n++) {
+        if (netFanout(net, n) > maxFanout) maxFanout = netFanout(net, n);
+    }
+
+    double avgFanout = (net->netCount > 0)
+        ? (double)pinCount / net->netCount
+        : 0.0;
+
+    printf("\n=== Netlist Statistics ===\n");
+    printf(" Total Modules:        %d\n", moduleCount);
+    printf(" Total Nets:           %d\n", net->netCount);
+    printf(" Total Pins:           %d\n", pinCount);
+    printf(" Average Fanout:       %.2f\n", avgFanout);
+    printf(" Maximum Fanout:       %d\n", maxFanout);
+
+    if (!net->offsets) {
+        printf("===========================\n\n");
+        return;
+    }
+
     long long totalDegree = 0;
     int zeroDegreeModules = 0;
     int maxDegree = 0;
@@ -76,13 +296,7 @@ void printNetlistStats(Netlist* net) {
     int hist[21] = {0};  // bucket 20 = overflow
 
     for (int m = 0; m < moduleCount; m++) {
-        Node* curr = net->adj[m];
-        int degree = 0;
-
-        while (curr) {
-            degree++;
-            curr = curr->next;
-        }
+        int degree = moduleDegree(net, m);
 
         totalDegree += degree;
 
@@ -99,8 +313,6 @@ void printNetlistStats(Netlist* net) {
         ? (double)totalDegree / moduleCount
         : 0.0;
 
-    printf("\n=== Netlist Statistics ===\n");
-    printf(" Total Modules:        %d\n", moduleCount);
     printf(" Zero-degree Modules:  %d\n", zeroDegreeModules);
     printf(" Average Degree:       %.2f\n", avgDegree);
     printf(" Maximum Degree:       %d\n", maxDegree);
@@ -124,9 +336,8 @@ void printNetlistStats(Netlist* net) {
 // - self-loops
 // ------------------------------------------------------------
 
-// simple non-STL hash mechanism
-static int seen[20000];
-static int seenTag = 1;
+// simple non-STL hash mechanism: seen[id] == seenTag marks
+// a neighbor already visited for the current module
 
 void checkNetlistIntegrity(Netlist* net) {
     if (!net) {
@@ -134,19 +345,26 @@ void checkNetlistIntegrity(Netlist* net) {
         return;
     }
 
+    if (!net->offsets) {
+        printf("ERROR: Clique adjacency not built.\n");
+        return;
+    }
+
     int moduleCount = net->moduleCount;
     int errors = 0;
 
+    int* seen = new int[moduleCount];
+    for (int i = 0; i < moduleCount; i++) seen[i] = 0;
+    int seenTag = 0;
+
     printf("\n=== Checking Netlist Integrity ===\n");
 
     for (int m = 0; m < moduleCount; m++) {
 
-        Node* curr = net->adj[m];
-
         seenTag++;   // new tag for this module
 
-        while (curr) {
-            int neigh = curr->module;
+        for (int e = net->offsets[m]; e < net->offsets[m + 1]; e++) {
+            int neigh = net->neighbors[e];
 
             // Out of bounds
             if (neigh < 0 || neigh >= moduleCount) {
@@ -161,17 +379,19 @@ void checkNetlistIntegrity(Netlist* net) {
             }
 
             // Duplicates detection
-            if (seen[neigh] == seenTag) {
-                printf("ERROR: Duplicate edge: %d ↔ %d\n", m, neigh);
-                errors++;
-            } else {
-                seen[neigh] = seenTag;
+            if (neigh >= 0 && neigh < moduleCount) {
+                if (seen[neigh] == seenTag) {
+                    printf("ERROR: Duplicate edge: %d ↔ %d\n", m, neigh);
+                    errors++;
+                } else {
+                    seen[neigh] = seenTag;
+                }
             }
-
-            curr = curr->next;
         }
     }
 
+    delete[] seen;
+
     if (errors == 0)
         printf("Netlist Integrity Check: PASSED.\n");
     else
@@ -180,38 +400,121 @@ void checkNetlistIntegrity(Netlist* net) {
     printf("==================================\n\n");
 }
 // ===========================================================
-// MEMORY POOL IMPLEMENTATION
+// MEMORY ARENA IMPLEMENTATION
 // ===========================================================
 
-static NodePool GLOBAL_POOL = {nullptr, 0, 0};
+#define POOL_DEFAULT_CHUNK (1 << 20)   // ints per chunk (4 MB)
+#define POOL_ALIGN_INTS    16          // 64-byte alignment
 
-void initNodePool(int capacity) {
-    GLOBAL_POOL.pool = (Node*)malloc(sizeof(Node) * capacity);
-    GLOBAL_POOL.capacity = capacity;
-    GLOBAL_POOL.used = 0;
+static NodePool GLOBAL_POOL = {nullptr, 0, 0, 0, 0};
 
-    if (!GLOBAL_POOL.pool) {
-        printf("ERROR: Failed to allocate node pool.\n");
+// ------------------------------------------------------------
+// Allocate a new chunk of at least 'capacity' ints and make it
+// the current one
+// ------------------------------------------------------------
+static void pushPoolChunk(int capacity) {
+    // round up so the chunk size is a multiple of the alignment
+    capacity = (capacity + POOL_ALIGN_INTS - 1) & ~(POOL_ALIGN_INTS - 1);
+
+    PoolChunk* chunk = new PoolChunk;
+    chunk->data = (int*)aligned_alloc(sizeof(int) * POOL_ALIGN_INTS,
+                                      sizeof(int) * (size_t)capacity);
+    if (!chunk->data) {
+        printf("ERROR: Failed to allocate node arena chunk (%d ints).\n", capacity);
         exit(1);
     }
+
+    chunk->capacity = capacity;
+    chunk->used = 0;
+    chunk->next = GLOBAL_POOL.head;
+
+    GLOBAL_POOL.head = chunk;
+    GLOBAL_POOL.reserved += capacity;
 }
 
-Node* allocNode() {
-    if (GLOBAL_POOL.used >= GLOBAL_POOL.capacity) {
-        printf("ERROR: Node pool exhausted (%d nodes).\n", GLOBAL_POOL.capacity);
+void initNodePool(int chunkSize) {
+    freeNodePool();
+
+    GLOBAL_POOL.chunkSize = (chunkSize > 0) ? chunkSize : POOL_DEFAULT_CHUNK;
+    pushPoolChunk(GLOBAL_POOL.chunkSize);
+}
+
+// ------------------------------------------------------------
+// Carve a contiguous run of 'count' ints out of the arena,
+// growing it by a new chunk if the current one is full
+// ------------------------------------------------------------
+int* allocNodes(int count) {
+    if (count < 0) {
+        printf("ERROR: Invalid node arena request (%d ints).\n", count);
         exit(1);
     }
 
-    Node* n = &GLOBAL_POOL.pool[GLOBAL_POOL.used++];
-    // no need to zero — we assign fields
-    return n;
+    if (!GLOBAL_POOL.head) initNodePool(0);
+
+    PoolChunk* chunk = GLOBAL_POOL.head;
+    int start = (chunk->used + POOL_ALIGN_INTS - 1) & ~(POOL_ALIGN_INTS - 1);
+
+    if (start > chunk->capacity || count > chunk->capacity - start) {
+        // oversized requests get a chunk of their own
+        int size = (count > GLOBAL_POOL.chunkSize) ? count : GLOBAL_POOL.chunkSize;
+        pushPoolChunk(size);
+        chunk = GLOBAL_POOL.head;
+        start = 0;
+    }
+
+    GLOBAL_POOL.used += (start - chunk->used) + count;
+    if (GLOBAL_POOL.used > GLOBAL_POOL.peak) GLOBAL_POOL.peak = GLOBAL_POOL.used;
+
+    chunk->used = start + count;
+    // no need to zero — caller fills every slot
+    return &chunk->data[start];
 }
 
-void freeNodePool() {
-    if (GLOBAL_POOL.pool) {
-        free(GLOBAL_POOL.pool);
-        GLOBAL_POOL.pool = nullptr;
-        GLOBAL_POOL.capacity = 0;
+// ------------------------------------------------------------
+// Bulk reset: free every chunk, then keep a single chunk sized
+// for the peak so the next build fits without growing
+// ------------------------------------------------------------
+void resetNodePool() {
+    if (!GLOBAL_POOL.head) return;
+
+    long long peak = GLOBAL_POOL.peak;
+    int chunkSize = GLOBAL_POOL.chunkSize;
+
+    if (GLOBAL_POOL.head->next == nullptr) {
+        // single chunk: just rewind it
+        GLOBAL_POOL.head->used = 0;
         GLOBAL_POOL.used = 0;
+        return;
     }
+
+    freeNodePool();
+
+    GLOBAL_POOL.chunkSize = chunkSize;
+    GLOBAL_POOL.peak = peak;
+    pushPoolChunk(peak > chunkSize && peak < 0x7fffffff ? (int)peak : chunkSize);
+}
+
+void freeNodePool() {
+    PoolChunk* chunk = GLOBAL_POOL.head;
+    while (chunk) {
+        PoolChunk* next = chunk->next;
+        free(chunk->data);
+        delete chunk;
+        chunk = next;
+    }
+
+    GLOBAL_POOL.head = nullptr;
+    GLOBAL_POOL.reserved = 0;
+    GLOBAL_POOL.used = 0;
+    GLOBAL_POOL.peak = 0;
+}
+
+void printNodePoolStats() {
+    int chunks = 0;
+    for (PoolChunk* c = GLOBAL_POOL.head; c; c = c->next) chunks++;
+
+    printf("Node arena: %d chunk(s), %.2f MB reserved, %.2f MB peak\n",
+           chunks,
+           (double)GLOBAL_POOL.reserved * sizeof(int) / (1024.0 * 1024.0),
+           (double)GLOBAL_POOL.peak * sizeof(int) / (1024.0 * 1024.0));
 }
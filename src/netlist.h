@@ -1,36 +1,129 @@
 #ifndef NETLIST_H
 #define NETLIST_H
 
-struct Node {
-    int module;
-    Node* next;
-};
+struct MappedFile;
 
 // ============================
-// Memory Pool for adjacency nodes
+// Memory arena for netlist storage
+// (hands out contiguous runs of ints for the CSR arrays)
+//
+// The arena grows by whole chunks, so it never runs out.
+// Each run starts on a 64-byte boundary.
 // ============================
+struct PoolChunk {
+    int* data;
+    int capacity;      // ints
+    int used;          // ints
+    PoolChunk* next;   // older chunk
+};
+
 struct NodePool {
-    Node* pool;
-    int capacity;
-    int used;
+    PoolChunk* head;   // chunk currently being filled
+    int chunkSize;     // default chunk size in ints
+    long long reserved;   // ints held by all chunks
+    long long used;       // ints handed out (incl. alignment padding)
+    long long peak;       // high-water mark of 'used'
 };
 
-void initNodePool(int capacity);
-Node* allocNode();
+// chunkSize: size hint for the first chunk in ints (0 = default).
+// Optional: allocNodes initializes the arena on first use.
+void initNodePool(int chunkSize);
+int* allocNodes(int count);
+
+// Drop every allocation at once. The arena keeps one chunk large
+// enough for the peak seen so far, so a rebuild needs no growth.
+void resetNodePool();
 void freeNodePool();
 
+// Print reserved / peak footprint of the arena
+void printNodePoolStats();
+
+// ============================
+// Net weights
+//
+// Weights are stored as fixed-point integers with WEIGHT_SHIFT
+// fractional bits (1.0 == WEIGHT_ONE), so the cost kernels stay
+// in integer arithmetic. Costs are in the same fixed-point units.
+// ============================
+#define WEIGHT_SHIFT 4
+#define WEIGHT_ONE   (1 << WEIGHT_SHIFT)
+
+// Convert a floating-point weight to fixed point (rounded, >= 0).
+// Positive weights below the resolution are clamped to 1 so the
+// net still counts (with weight 1 / WEIGHT_ONE).
+inline int weightToFixed(double w) {
+    if (w <= 0.0) return 0;
+    int fixed = (int)(w * WEIGHT_ONE + 0.5);
+    return (fixed > 0) ? fixed : 1;
+}
+
 // ============================
-// Existing netlist structures
+// Netlist
+//
+// Hypergraph (always present, grows with pin count):
+//   pins of net n     : netPins[netOffsets[n]] .. netPins[netOffsets[n+1] - 1]
+//   weight of net n   : netWeights[n]
+//   nets of module m  : modNets[modOffsets[m]] .. modNets[modOffsets[m+1] - 1]
+//
+// Clique adjacency in CSR form (derived on demand by
+// buildCliqueAdjacency, nullptr until then):
+//   neighbors of m    : neighbors[offsets[m]] .. neighbors[offsets[m+1] - 1]
+//   edge weights      : edgeWeights[e] for neighbors[e]
 // ============================
 struct Netlist {
     int moduleCount;
-    Node** adj;
+    int netCount;
+
+    int* netOffsets;  // size netCount + 1
+    int* netPins;     // size netOffsets[netCount]
+    int* netWeights;  // size netCount, fixed point
+    int* modOffsets;  // size moduleCount + 1
+    int* modNets;     // size modOffsets[moduleCount]
+
+    int* offsets;     // size moduleCount + 1
+    int* neighbors;   // size offsets[moduleCount]
+    int* edgeWeights; // size offsets[moduleCount], fixed point
+
+    // Hypergraph arrays point into this mapping when loaded from
+    // a binary cache (nullptr: they live in the node arena)
+    MappedFile* mapping;
 };
 
-Netlist* initNetlist(int moduleCount);
-void addEdge(Netlist* net, int a, int b);
+// Build the hypergraph from a list of nets.
+// Pins of net n are netPins[netOffsets[n]] .. netPins[netOffsets[n+1] - 1];
+// pins with invalid IDs and repeats of a module within one net are dropped
+// (the HPWL edge counts assume distinct pins). The arrays are copied into
+// the node arena.
+// netWeights holds one fixed-point weight per net (nullptr: all WEIGHT_ONE).
+Netlist* initNetlistFromNets(int moduleCount, int netCount,
+                             const int* netOffsets, const int* netPins,
+                             const int* netWeights = nullptr);
+
+// Nets with more pins than this stay out of the clique adjacency: a net
+// of fanout F adds F * (F - 1) entries, so a single clock or reset net
+// would dominate memory. The clique cost ignores them; HPWL sees every net.
+#define CLIQUE_MAX_FANOUT 256
+
+// Derive the clique-expanded CSR adjacency from the hypergraph
+// (count-then-fill). Every clique edge carries the weight of its net;
+// modules sharing several nets get a single edge with the summed weight.
+// Required by the clique cost model in cost2D.
+// Returns 0 (adjacency not built) if the expansion exceeds int indexing.
+int buildCliqueAdjacency(Netlist* net);
+
+// Free the netlist (and its cache mapping, if any)
 void freeNetlist(Netlist* net);
 
+// Number of neighbors of module m (clique adjacency must be built)
+inline int moduleDegree(const Netlist* net, int m) {
+    return net->offsets[m + 1] - net->offsets[m];
+}
+
+// Number of pins on net n
+inline int netFanout(const Netlist* net, int n) {
+    return net->netOffsets[n + 1] - net->netOffsets[n];
+}
+
 void printNetlist(Netlist* net);
 void printNetlistStats(Netlist* net);
 void checkNetlistIntegrity(Netlist* net);
@@ -0,0 +1,289 @@
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <sys/stat.h>
+
+#include "netlist_cache.h"
+#include "netlist.h"
+#include "csv_parser.h"
+#include "mapped_file.h"
+
+#define CACHE_MAGIC      "NLCACHE"
+#define CACHE_ENDIAN_TAG 0x01020304u
+#define CACHE_ALIGN      64
+
+enum {
+    SEC_NET_OFFSETS,
+    SEC_NET_PINS,
+    SEC_NET_WEIGHTS,
+    SEC_MOD_OFFSETS,
+    SEC_MOD_NETS,
+    SEC_COUNT
+};
+
+struct NetlistCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;
+    int32_t weightShift;     // fixed-point format of the weights
+    int32_t moduleCount;
+    int32_t netCount;
+    int32_t pinCount;
+    int64_t sourceSize;
+    int64_t sourceMtime;     // seconds
+    int64_t sourceMtimeNsec; // nanoseconds within the second (0 if unknown)
+    uint64_t sourceHash;     // FNV-1a over the source file bytes
+    uint64_t contentHash;    // FNV-1a over the counts and all sections
+    int64_t sectionOffset[SEC_COUNT];   // bytes from file start
+    int64_t sectionLength[SEC_COUNT];   // ints
+};
+
+#define FNV_OFFSET 1469598103934665603ull
+
+// ----------------------------------------------------------
+// Size and mtime of the source file (0 if it can't be read);
+// nanoseconds where the platform keeps them
+// ----------------------------------------------------------
+static int statSource(const char* path, int64_t* size, int64_t* mtime, int64_t* mtimeNsec) {
+    struct stat st;
+    if (stat(path, &st) != 0) return 0;
+    *size = (int64_t)st.st_size;
+    *mtime = (int64_t)st.st_mtime;
+#if defined(__APPLE__)
+    *mtimeNsec = (int64_t)st.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+    *mtimeNsec = 0;
+#else
+    *mtimeNsec = (int64_t)st.st_mtim.tv_nsec;
+#endif
+    return 1;
+}
+
+// ----------------------------------------------------------
+// 64-bit FNV-1a, chained across sections
+// ----------------------------------------------------------
+static uint64_t hashBytes(uint64_t h, const void* data, int64_t bytes) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (int64_t i = 0; i < bytes; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static uint64_t hashInts(uint64_t h, const int* data, int64_t count) {
+    return hashBytes(h, data, count * (int64_t)sizeof(int));
+}
+
+// Hash of the source file contents (0 if it can't be mapped)
+static int hashSource(const char* path, uint64_t* hash) {
+    MappedFile mf;
+    if (!mapFile(path, &mf)) return 0;
+    *hash = hashBytes(FNV_OFFSET, mf.data, (int64_t)mf.size);
+    unmapFile(&mf);
+    return 1;
+}
+
+// Hash seed covering the header counts, so edited counts fail verification
+static uint64_t hashCounts(const NetlistCacheHeader* h) {
+    int counts[3] = { h->moduleCount, h->netCount, h->pinCount };
+    return hashInts(FNV_OFFSET, counts, 3);
+}
+
+// ----------------------------------------------------------
+// Structural check, run on every load (O(pins)): offsets start at
+// 0, never decrease and end at itemCount; every pin / net ID in
+// range, so later passes can index with them unchecked
+// ----------------------------------------------------------
+static int checkCSR(const int* offsets, int rows, const int* items, int itemCount, int idLimit) {
+    if (offsets[0] != 0 || offsets[rows] != itemCount) return 0;
+    for (int i = 0; i < rows; i++)
+        if (offsets[i + 1] < offsets[i]) return 0;
+    for (int k = 0; k < itemCount; k++)
+        if (items[k] < 0 || items[k] >= idLimit) return 0;
+    return 1;
+}
+
+static int64_t alignUp(int64_t x) {
+    return (x + CACHE_ALIGN - 1) & ~(int64_t)(CACHE_ALIGN - 1);
+}
+
+// ----------------------------------------------------------
+// Writer
+// ----------------------------------------------------------
+int writeNetlistCache(const char* cachePath, const char* sourcePath, const Netlist* net) {
+    if (!net) return 0;
+
+    NetlistCacheHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    h.version = NETLIST_CACHE_VERSION;
+    h.endianTag = CACHE_ENDIAN_TAG;
+    h.weightShift = WEIGHT_SHIFT;
+    h.moduleCount = net->moduleCount;
+    h.netCount = net->netCount;
+    h.pinCount = net->netOffsets[net->netCount];
+
+    if (!statSource(sourcePath, &h.sourceSize, &h.sourceMtime, &h.sourceMtimeNsec) ||
+        !hashSource(sourcePath, &h.sourceHash))
+        return 0;
+
+    const int* sections[SEC_COUNT] = {
+        net->netOffsets, net->netPins, net->netWeights, net->modOffsets, net->modNets
+    };
+    h.sectionLength[SEC_NET_OFFSETS] = net->netCount + 1;
+    h.sectionLength[SEC_NET_PINS]    = h.pinCount;
+    h.sectionLength[SEC_NET_WEIGHTS] = net->netCount;
+    h.sectionLength[SEC_MOD_OFFSETS] = net->moduleCount + 1;
+    h.sectionLength[SEC_MOD_NETS]    = h.pinCount;
+
+    int64_t pos = alignUp(sizeof(h));
+    uint64_t hash = hashCounts(&h);
+    for (int s = 0; s < SEC_COUNT; s++) {
+        h.sectionOffset[s] = pos;
+        pos = alignUp(pos + h.sectionLength[s] * (int64_t)sizeof(int));
+        hash = hashInts(hash, sections[s], h.sectionLength[s]);
+    }
+    h.contentHash = hash;
+
+    FILE* fp = fopen(cachePath, "wb");
+    if (!fp) {
+        printf("WARNING: Cannot write netlist cache: %s\n", cachePath);
+        return 0;
+    }
+
+    static const char zeros[CACHE_ALIGN] = {0};
+    int ok = (fwrite(&h, sizeof(h), 1, fp) == 1);
+    int64_t written = sizeof(h);
+
+    for (int s = 0; s < SEC_COUNT && ok; s++) {
+        ok = ok && fwrite(zeros, 1, (size_t)(h.sectionOffset[s] - written), fp)
+                   == (size_t)(h.sectionOffset[s] - written);
+        ok = ok && fwrite(sections[s], sizeof(int), (size_t)h.sectionLength[s], fp)
+                   == (size_t)h.sectionLength[s];
+        written = h.sectionOffset[s] + h.sectionLength[s] * (int64_t)sizeof(int);
+    }
+
+    if (fclose(fp) != 0) ok = 0;
+
+    if (!ok) {
+        printf("WARNING: Failed writing netlist cache: %s\n", cachePath);
+        remove(cachePath);
+    }
+    return ok;
+}
+
+// ----------------------------------------------------------
+// Loader (zero-copy)
+// ----------------------------------------------------------
+Netlist* loadNetlistCache(const char* cachePath, const char* sourcePath, int* moduleCountOut,
+                          int verify)
+{
+    MappedFile* mf = new MappedFile;
+    if (!mapFile(cachePath, mf)) {
+        delete mf;
+        return nullptr;
+    }
+
+    const NetlistCacheHeader* h = (const NetlistCacheHeader*)mf->data;
+    int valid = mf->size >= sizeof(NetlistCacheHeader) &&
+                memcmp(h->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+                h->version == NETLIST_CACHE_VERSION &&
+                h->endianTag == CACHE_ENDIAN_TAG &&
+                h->weightShift == WEIGHT_SHIFT;
+
+    // stale if the source changed since the cache was written
+    int64_t size, mtime, mtimeNsec;
+    if (valid && sourcePath) {
+        valid = statSource(sourcePath, &size, &mtime, &mtimeNsec) &&
+                size == h->sourceSize && mtime == h->sourceMtime &&
+                mtimeNsec == h->sourceMtimeNsec;
+    }
+
+    // section lengths must follow from the header counts
+    if (valid) {
+        valid = h->moduleCount >= 0 && h->netCount >= 0 && h->pinCount >= 0 &&
+                h->sectionLength[SEC_NET_OFFSETS] == (int64_t)h->netCount + 1 &&
+                h->sectionLength[SEC_NET_PINS]    == h->pinCount &&
+                h->sectionLength[SEC_NET_WEIGHTS] == h->netCount &&
+                h->sectionLength[SEC_MOD_OFFSETS] == (int64_t)h->moduleCount + 1 &&
+                h->sectionLength[SEC_MOD_NETS]    == h->pinCount;
+    }
+
+    // every section inside the mapping (no overflow on bad offsets)
+    const int* sections[SEC_COUNT];
+    int64_t fileSize = (int64_t)mf->size;
+    for (int s = 0; s < SEC_COUNT && valid; s++) {
+        int64_t off = h->sectionOffset[s];
+        valid = off >= (int64_t)sizeof(NetlistCacheHeader) && off % CACHE_ALIGN == 0 &&
+                off <= fileSize &&
+                h->sectionLength[s] <= (fileSize - off) / (int64_t)sizeof(int);
+        if (valid) sections[s] = (const int*)(mf->data + off);
+    }
+
+    // CSR offsets and IDs: every later pass indexes through these
+    if (valid) {
+        valid = checkCSR(sections[SEC_NET_OFFSETS], h->netCount,
+                         sections[SEC_NET_PINS], h->pinCount, h->moduleCount) &&
+                checkCSR(sections[SEC_MOD_OFFSETS], h->moduleCount,
+                         sections[SEC_MOD_NETS], h->pinCount, h->netCount);
+        if (!valid) printf("WARNING: Netlist cache is corrupt: %s\n", cachePath);
+    }
+
+    // content hashes of the cache and of the source it was built from
+    if (valid && verify) {
+        uint64_t hash = hashCounts(h);
+        for (int s = 0; s < SEC_COUNT; s++)
+            hash = hashInts(hash, sections[s], h->sectionLength[s]);
+        uint64_t sourceHash = 0;
+        valid = (hash == h->contentHash) &&
+                (!sourcePath || (hashSource(sourcePath, &sourceHash) &&
+                                 sourceHash == h->sourceHash));
+        if (!valid) printf("WARNING: Netlist cache failed verification: %s\n", cachePath);
+    }
+
+    if (!valid) {
+        unmapFile(mf);
+        delete mf;
+        return nullptr;
+    }
+
+    // The arrays are read-only in the mapping; nothing writes the
+    // hypergraph after it is built.
+    Netlist* net = new Netlist;
+    net->moduleCount = h->moduleCount;
+    net->netCount    = h->netCount;
+    net->netOffsets  = (int*)sections[SEC_NET_OFFSETS];
+    net->netPins     = (int*)sections[SEC_NET_PINS];
+    net->netWeights  = (int*)sections[SEC_NET_WEIGHTS];
+    net->modOffsets  = (int*)sections[SEC_MOD_OFFSETS];
+    net->modNets     = (int*)sections[SEC_MOD_NETS];
+    net->offsets     = nullptr;
+    net->neighbors   = nullptr;
+    net->edgeWeights = nullptr;
+    net->mapping     = mf;
+
+    *moduleCountOut = net->moduleCount;
+    return net;
+}
+
+// ----------------------------------------------------------
+// CSV load through "<csvPath>.bin", with fallback to the CSV
+// ----------------------------------------------------------
+Netlist* loadNetlistCached(const char* csvPath, int* moduleCountOut, int verify) {
+    char cachePath[4096];
+    if (snprintf(cachePath, sizeof(cachePath), "%s.bin", csvPath) >= (int)sizeof(cachePath))
+        return parseCSVNetlist(csvPath, moduleCountOut);
+
+    Netlist* net = loadNetlistCache(cachePath, csvPath, moduleCountOut, verify);
+    if (net) {
+        printf("Netlist cache hit: %s\n", cachePath);
+        return net;
+    }
+
+    net = parseCSVNetlist(csvPath, moduleCountOut);
+    if (net && writeNetlistCache(cachePath, csvPath, net))
+        printf("Netlist cache written: %s\n", cachePath);
+
+    return net;
+}
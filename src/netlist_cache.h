@@ -0,0 +1,40 @@
+#ifndef NETLIST_CACHE_H
+#define NETLIST_CACHE_H
+
+#include "netlist.h"
+
+// ----------------------------------------------------------
+// Binary netlist cache
+//
+// Layout (little-endian, every section 64-byte aligned):
+//   header   : magic, version, counts, source file size / mtime
+//              (with nanoseconds) / content hash, cache content
+//              hash, section offsets
+//   sections : netOffsets, netPins, netWeights, modOffsets, modNets
+//
+// The loader maps the file and points the Netlist straight at
+// the sections (zero-copy); the mapping lives until freeNetlist.
+// Every load checks the header (format, source size and mtime,
+// section bounds) and the CSR structure (monotonic offsets, pin
+// and net IDs in range), O(pins) in all. Hashing the sections and
+// the source file is an opt-in verification.
+// ----------------------------------------------------------
+
+#define NETLIST_CACHE_VERSION 4
+
+// Write the hypergraph of 'net' to cachePath, stamped with the size,
+// mtime and content hash of sourcePath. Returns 1 on success, 0 on failure.
+int writeNetlistCache(const char* cachePath, const char* sourcePath, const Netlist* net);
+
+// Map a cache file. Returns nullptr if it is missing, malformed, from
+// another version, or stale (sourcePath size / mtime differ). verify != 0
+// also checks the content hash and the hash of sourcePath, which catches
+// same-size edits within the mtime resolution (O(file sizes)).
+Netlist* loadNetlistCache(const char* cachePath, const char* sourcePath, int* moduleCountOut,
+                          int verify = 0);
+
+// Load a CSV netlist through its cache "<csvPath>.bin": use the cache
+// when it is fresh, otherwise parse the CSV and (re)write the cache.
+Netlist* loadNetlistCached(const char* csvPath, int* moduleCountOut, int verify = 0);
+
+#endif
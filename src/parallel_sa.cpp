@@ -0,0 +1,87 @@
+#include <cstdio>
+#include <climits>
+
+#include "parallel_sa.h"
+#include "rng.h"
+#include "threads.h"
+
+// ----------------------------------------------------------
+// Private state of one annealing run
+// ----------------------------------------------------------
+struct SARun {
+    Grid* g;
+    int* mod_x;
+    int* mod_y;
+    long long cost;
+};
+
+long long parallelSimulatedAnnealing2D(Grid* g, Netlist* net, int mod_x[], int mod_y[],
+                                       int moduleCount, const SAParams* params, int runs)
+{
+    if (runs <= 0) runs = hardwareThreads();
+
+    SAParams base;
+    if (params) base = *params;
+    else initSAParams(&base);
+
+    SASharedBest shared;
+    initSASharedBest(&shared);
+
+    SAParams runParams = base;
+    runParams.shared = &shared;
+    runParams.verbose = 0;
+
+    // -------------------------------------------------------
+    // Private copies of the starting placement
+    // -------------------------------------------------------
+    SARun* state = new SARun[runs];
+    for (int k = 0; k < runs; k++) {
+        state[k].g = copyGrid(g);
+        state[k].mod_x = new int[moduleCount];
+        state[k].mod_y = new int[moduleCount];
+        for (int m = 0; m < moduleCount; m++) {
+            state[k].mod_x[m] = mod_x[m];
+            state[k].mod_y[m] = mod_y[m];
+        }
+        state[k].cost = LLONG_MAX;
+    }
+
+    printf("Multi-start annealing: %d runs\n", runs);
+
+    runOnThreads(runs, [&](int k) {
+        seedThreadRng((uint64_t)k + 1);
+        state[k].cost = simulatedAnnealing2D(state[k].g, net,
+                                             state[k].mod_x, state[k].mod_y,
+                                             moduleCount, &runParams);
+    });
+
+    // -------------------------------------------------------
+    // Keep the best run
+    // -------------------------------------------------------
+    int winner = 0;
+    for (int k = 0; k < runs; k++) {
+        printf("  run %d: best cost %lld\n", k, state[k].cost);
+        if (state[k].cost < state[winner].cost) winner = k;
+    }
+
+    for (int m = 0; m < moduleCount; m++) {
+        mod_x[m] = state[winner].mod_x[m];
+        mod_y[m] = state[winner].mod_y[m];
+    }
+
+    clearGrid(g);
+    for (int m = 0; m < moduleCount; m++)
+        placeModuleAt(g, m, mod_x[m], mod_y[m]);
+
+    long long bestCost = state[winner].cost;
+    printf("Final Best 2D Cost: %lld (run %d of %d)\n", bestCost, winner, runs);
+
+    for (int k = 0; k < runs; k++) {
+        freeGrid(state[k].g);
+        delete[] state[k].mod_x;
+        delete[] state[k].mod_y;
+    }
+    delete[] state;
+
+    return bestCost;
+}
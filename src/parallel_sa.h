@@ -0,0 +1,19 @@
+#ifndef PARALLEL_SA_H
+#define PARALLEL_SA_H
+
+#include "grid.h"
+#include "netlist.h"
+#include "sa_timing.h"
+
+// Multi-start annealing: 'runs' independent annealers on their own
+// threads, each with a private copy of the grid and placement and its
+// own RNG stream (run k uses stream k + 1 of the global seed). The
+// netlist is shared read-only. Runs publish their best cost to a
+// shared lock-free record and clearly losing runs stop early (see
+// SA_CUTOFF_*). The best placement is written back into g / mod_x /
+// mod_y and its cost returned. runs <= 0 uses one run per hardware
+// thread.
+long long parallelSimulatedAnnealing2D(Grid* g, Netlist* net, int mod_x[], int mod_y[],
+                                       int moduleCount, const SAParams* params, int runs);
+
+#endif
@@ -54,38 +54,54 @@ Netlist* parseNetlistFile(const char* filename, int* moduleCountOut) {
     int moduleCount = maxModule + 1;
     *moduleCountOut = moduleCount;
 
-    Netlist* netlist = initNetlist(moduleCount);
-
-    // Second pass: build edges
+    // Collected nets: pins of net n are netPins[netOffsets[n] .. netOffsets[n+1]-1]
+    int netCap = 1024, pinCap = 4096;
+    int netCount = 0, pinCount = 0;
+    int* netOffsets = (int*)malloc(sizeof(int) * (netCap + 1));
+    int* netPins    = (int*)malloc(sizeof(int) * pinCap);
+    int* netWeights = (int*)malloc(sizeof(int) * netCap);
+    netOffsets[0] = 0;
+
+    // Second pass: collect pins of every net
     while (fgets(line, sizeof(line), fp)) {
         char* saveptr;
         strtok_r(line, "\t", &saveptr); // netname
-        strtok_r(nullptr, "\t", &saveptr); // weight
+        char* weight = strtok_r(nullptr, "\t", &saveptr);
         char* blocks = strtok_r(nullptr, "\t", &saveptr);
         if (!blocks) continue;
 
-        // parse block list into array
-        int modules[512];
-        int count = 0;
-
         char* bsave;
         char* token = strtok_r(blocks, " ", &bsave);
 
         while (token) {
             int id = parseBlockID(token);
-            if (id >= 0) modules[count++] = id;
+            if (id >= 0) {
+                if (pinCount == pinCap) {
+                    pinCap *= 2;
+                    netPins = (int*)realloc(netPins, sizeof(int) * pinCap);
+                }
+                netPins[pinCount++] = id;
+            }
             token = strtok_r(nullptr, " ", &bsave);
         }
 
-        // Build complete clique adjacency
-        for (int i = 0; i < count; i++) {
-            for (int j = i + 1; j < count; j++) {
-                addEdge(netlist, modules[i], modules[j]);
-                addEdge(netlist, modules[j], modules[i]);
-            }
+        if (netCount == netCap) {
+            netCap *= 2;
+            netOffsets = (int*)realloc(netOffsets, sizeof(int) * (netCap + 1));
+            netWeights = (int*)realloc(netWeights, sizeof(int) * netCap);
         }
+        netWeights[netCount] = weightToFixed(atof(weight));
+        netOffsets[++netCount] = pinCount;
     }
 
     fclose(fp);
+
+    // Build hypergraph
+    Netlist* netlist = initNetlistFromNets(moduleCount, netCount, netOffsets, netPins,
+                                           netWeights);
+
+    free(netOffsets);
+    free(netPins);
+    free(netWeights);
     return netlist;
 }
@@ -0,0 +1,331 @@
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "partitioned_sa.h"
+#include "cost2D.h"
+#include "move2D.h"
+#include "rng.h"
+#include "schedule.h"
+#include "threads.h"
+
+// ----------------------------------------------------------
+// Per-thread state (RNG stream, position snapshot and counters of
+// one phase)
+// ----------------------------------------------------------
+struct PSAWorker {
+    Rng rng;
+    unsigned int* pos;    // private copy of g->modPos, refreshed every phase
+    long long delta;      // summed accepted deltas
+    int accepted;
+    int attempted;
+};
+
+// Cell bounds of a tile: rows [r0, r1), cols [c0, c1)
+struct TileBounds {
+    int r0, r1, c0, c1;
+};
+
+// One color phase, handed to the worker pool
+struct PSAPhase {
+    Grid* g;
+    Netlist* net;
+    int* mod_x;
+    int* mod_y;
+    const char* isFixed;
+    const TileBounds* tiles;
+    int tileCount;
+    int rlim;
+    double T;
+    int moves;
+    PSAWorker* workers;
+    int threads;
+};
+
+// ----------------------------------------------------------
+// Tile-local moves. They write the cells and modules of the tile
+// plus the thread's own position snapshot, never g->modPos (other
+// threads read it during the phase); the free-site index and
+// g->modPos are brought up to date after the phase.
+// ----------------------------------------------------------
+static void relocateInTile(Grid* g, int mod_x[], int mod_y[], unsigned int pos[],
+                           int module, int r, int c)
+{
+    g->cells[mod_x[module] * g->cols + mod_y[module]] = EMPTY_CELL;
+    g->cells[r * g->cols + c] = module;
+    mod_x[module] = r;
+    mod_y[module] = c;
+    pos[module] = POS_PACK(r, c);
+}
+
+static void swapInTile(Grid* g, int mod_x[], int mod_y[], unsigned int pos[], int m1, int m2) {
+    int r1 = mod_x[m1], c1 = mod_y[m1];
+    int r2 = mod_x[m2], c2 = mod_y[m2];
+
+    g->cells[r1 * g->cols + c1] = m2;
+    g->cells[r2 * g->cols + c2] = m1;
+    mod_x[m1] = r2;
+    mod_y[m1] = c2;
+    mod_x[m2] = r1;
+    mod_y[m2] = c1;
+
+    unsigned int p = pos[m1];
+    pos[m1] = pos[m2];
+    pos[m2] = p;
+}
+
+// ----------------------------------------------------------
+// Metropolis moves inside one tile; partners come from a window
+// of rlim around the first cell, clipped to the tile. Deltas read
+// the worker's snapshot: exact inside the tile, phase-start
+// positions for modules in other tiles.
+// ----------------------------------------------------------
+static void annealTile(Grid* g, Netlist* net, int mod_x[], int mod_y[],
+                       const char isFixed[], const TileBounds* t,
+                       int rlim, double T, int moves, PSAWorker* w)
+{
+    Rng* rng = &w->rng;
+    unsigned int* pos = w->pos;
+
+    for (int k = 0; k < moves; k++) {
+        int ra = rngRange(rng, t->r0, t->r1 - 1);
+        int ca = rngRange(rng, t->c0, t->c1 - 1);
+        int m1 = g->cells[ra * g->cols + ca];
+        if (m1 == EMPTY_CELL || (isFixed && isFixed[m1])) continue;
+
+        int rLo = ra - rlim < t->r0 ? t->r0 : ra - rlim;
+        int rHi = ra + rlim >= t->r1 ? t->r1 - 1 : ra + rlim;
+        int cLo = ca - rlim < t->c0 ? t->c0 : ca - rlim;
+        int cHi = ca + rlim >= t->c1 ? t->c1 - 1 : ca + rlim;
+
+        int rb = rngRange(rng, rLo, rHi);
+        int cb = rngRange(rng, cLo, cHi);
+        if (rb == ra && cb == ca) continue;
+
+        int m2 = g->cells[rb * g->cols + cb];
+        if (m2 != EMPTY_CELL && isFixed && isFixed[m2]) continue;
+
+        int delta = (m2 == EMPTY_CELL)
+            ? computeDeltaCostMovePacked2D(net, pos, m1, rb, cb)
+            : computeDeltaCostSwapPacked2D(net, pos, m1, m2);
+        w->attempted++;
+
+        if (delta > 0 && rngUniform(rng) >= exp(-((double)delta) / T))
+            continue;
+
+        if (m2 == EMPTY_CELL)
+            relocateInTile(g, mod_x, mod_y, pos, m1, rb, cb);
+        else
+            swapInTile(g, mod_x, mod_y, pos, m1, m2);
+
+        w->delta += delta;
+        w->accepted++;
+    }
+}
+
+// Worker i: refresh its snapshot, then anneal tiles i, i + threads, ...
+static void annealPhase(void* ctx, int i) {
+    PSAPhase* ph = (PSAPhase*)ctx;
+    PSAWorker* w = &ph->workers[i];
+    w->delta = 0;
+    w->accepted = 0;
+    w->attempted = 0;
+
+    memcpy(w->pos, ph->g->modPos, sizeof(unsigned int) * ph->g->moduleCount);
+
+    for (int t = i; t < ph->tileCount; t += ph->threads) {
+        annealTile(ph->g, ph->net, ph->mod_x, ph->mod_y, ph->isFixed, &ph->tiles[t],
+                   ph->rlim, ph->T, ph->moves, w);
+    }
+}
+
+long long partitionedAnnealing2D(Grid* g, Netlist* net, int mod_x[], int mod_y[],
+                                 int moduleCount, const SAParams* params,
+                                 int threads, int tileSize)
+{
+    SAParams defaults;
+    initSAParams(&defaults);
+    if (!params) params = &defaults;
+
+    if (params->costModel == COST_HPWL) {
+        printf("Partitioned annealing supports the clique model only; running serially.\n");
+        return simulatedAnnealing2D(g, net, mod_x, mod_y, moduleCount, params);
+    }
+
+    if (threads <= 0) threads = hardwareThreads();
+    if (tileSize <= 0) tileSize = PSA_DEFAULT_TILE;
+
+    int* movable = new int[moduleCount];
+    int movableCount = buildMovableList(params->isFixed, moduleCount, movable);
+
+    initGridPositions(g, moduleCount);
+    long long currentCost = computeCost2D(net, mod_x, mod_y);
+    long long bestCost = currentCost;
+
+    if (movableCount < 2) {
+        printf("Nothing to anneal: %d movable module(s).\n", movableCount);
+        delete[] movable;
+        return currentCost;
+    }
+
+    // -------------------------------------------------------
+    // Schedule (T0 from random swap deltas, as the serial annealer)
+    // -------------------------------------------------------
+    Rng* rng = threadRng();
+    int sampleCount = movableCount < 1000 ? movableCount : 1000;
+    int* deltas = new int[sampleCount];
+    for (int k = 0; k < sampleCount; k++) {
+        int a, b;
+        generateRandomMovablePair(movable, movableCount, &a, &b);
+        deltas[k] = computeDeltaCostSwapPacked2D(net, g->modPos, a, b);
+    }
+
+    AnnealSchedule sched;
+    initSchedule(&sched, params->t0Scale * initialTemperature(deltas, sampleCount),
+                 net->netCount);
+    delete[] deltas;
+
+    // tiles per axis, with one spare row/column of tiles for the shift
+    int tileRows = g->rows / tileSize + 2;
+    int tileCols = g->cols / tileSize + 2;
+    int tileCount = tileRows * tileCols;
+    TileBounds* tiles = new TileBounds[tileCount];
+    int movesPerTile = movableCount / ((g->rows * g->cols + tileSize * tileSize - 1) /
+                                       (tileSize * tileSize));
+    if (movesPerTile < 1) movesPerTile = 1;
+
+    PSAWorker* workers = new PSAWorker[threads];
+    for (int i = 0; i < threads; i++) {
+        seedRng(&workers[i].rng, getRandomSeed(), (uint64_t)i + 1);
+        workers[i].pos = new unsigned int[moduleCount];
+    }
+
+    WorkerPool* pool = createWorkerPool(threads);
+
+    PSAPhase phase;
+    phase.g = g;
+    phase.net = net;
+    phase.mod_x = mod_x;
+    phase.mod_y = mod_y;
+    phase.isFixed = params->isFixed;
+    phase.tiles = tiles;
+    phase.moves = movesPerTile;
+    phase.workers = workers;
+    phase.threads = threads;
+
+    int* best_x = new int[moduleCount];
+    int* best_y = new int[moduleCount];
+    for (int m = 0; m < moduleCount; m++) {
+        best_x[m] = mod_x[m];
+        best_y[m] = mod_y[m];
+    }
+
+    double rlim = tileSize;
+    long long maxDrift = 0;
+
+    printf("Partitioned annealing: %d threads, %dx%d tiles, T0 = %.2f\n",
+           threads, tileSize, tileSize, sched.T / WEIGHT_ONE);
+
+    while (!sched.done) {
+        double T = sched.T;
+        int accepted = 0, attempted = 0;
+        long long deltaSum = 0;
+
+        // shift the tile grid so tile borders move between temperatures
+        int offR = rngRange(rng, 0, tileSize - 1);
+        int offC = rngRange(rng, 0, tileSize - 1);
+
+        for (int color = 0; color < 4; color++) {
+            // tiles of this color, clipped to the grid
+            int count = 0;
+            for (int tr = color >> 1; tr < tileRows; tr += 2) {
+                for (int tc = color & 1; tc < tileCols; tc += 2) {
+                    TileBounds b;
+                    b.r0 = tr * tileSize - offR;
+                    b.c0 = tc * tileSize - offC;
+                    b.r1 = b.r0 + tileSize;
+                    b.c1 = b.c0 + tileSize;
+                    if (b.r0 < 0) b.r0 = 0;
+                    if (b.c0 < 0) b.c0 = 0;
+                    if (b.r1 > g->rows) b.r1 = g->rows;
+                    if (b.c1 > g->cols) b.c1 = g->cols;
+                    if (b.r1 - b.r0 < 1 || b.c1 - b.c0 < 1) continue;
+                    if ((b.r1 - b.r0) * (b.c1 - b.c0) < 2) continue;
+                    tiles[count++] = b;
+                }
+            }
+
+            phase.tileCount = count;
+            phase.rlim = (int)rlim;
+            phase.T = T;
+            runOnPool(pool, annealPhase, &phase);
+
+            for (int i = 0; i < threads; i++) {
+                deltaSum += workers[i].delta;
+                accepted += workers[i].accepted;
+                attempted += workers[i].attempted;
+            }
+
+            // publish the phase's moves: positions of the modules now
+            // in this color's tiles, and the shared free-site index
+            for (int t = 0; t < count; t++) {
+                for (int r = tiles[t].r0; r < tiles[t].r1; r++) {
+                    for (int c = tiles[t].c0; c < tiles[t].c1; c++) {
+                        int m = g->cells[r * g->cols + c];
+                        if (m != EMPTY_CELL) g->modPos[m] = POS_PACK(r, c);
+                    }
+                }
+            }
+            rebuildFreeSites(g);
+        }
+
+        // -------------------------------------------------------
+        // Exact resync: phase-start positions of modules in other
+        // tiles make the summed deltas drift from the true cost
+        // -------------------------------------------------------
+        long long tracked = currentCost + deltaSum;
+        currentCost = computeCost2D(net, mod_x, mod_y);
+        long long drift = llabs(tracked - currentCost);
+        if (drift > maxDrift) maxDrift = drift;
+
+        if (currentCost < bestCost) {
+            bestCost = currentCost;
+            for (int m = 0; m < moduleCount; m++) {
+                best_x[m] = mod_x[m];
+                best_y[m] = mod_y[m];
+            }
+        }
+
+        advanceSchedule(&sched, accepted, attempted, currentCost);
+        rlim = updateWindowLimit2D(g, rlim, sched.acceptRate);
+        if (rlim > tileSize) rlim = tileSize;
+
+        if (params->verbose)
+            printf("T = %.2f, Current Cost = %lld, Best = %lld, Accepted = %.1f%%, Drift = %lld\n",
+                   T / WEIGHT_ONE, currentCost, bestCost, 100.0 * sched.acceptRate, drift);
+    }
+
+    for (int m = 0; m < moduleCount; m++) {
+        mod_x[m] = best_x[m];
+        mod_y[m] = best_y[m];
+    }
+
+    clearGrid(g);
+    for (int m = 0; m < moduleCount; m++)
+        placeModuleAt(g, m, mod_x[m], mod_y[m]);
+
+    printf("Final Best 2D Cost: %lld after %d temperatures (max drift %lld)\n",
+           bestCost, sched.temps, maxDrift);
+
+    destroyWorkerPool(pool);
+    for (int i = 0; i < threads; i++) delete[] workers[i].pos;
+
+    delete[] best_x;
+    delete[] best_y;
+    delete[] workers;
+    delete[] tiles;
+    delete[] movable;
+
+    return bestCost;
+}
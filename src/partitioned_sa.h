@@ -0,0 +1,37 @@
+#ifndef PARTITIONED_SA_H
+#define PARTITIONED_SA_H
+
+#include "grid.h"
+#include "netlist.h"
+#include "sa_timing.h"
+
+// ----------------------------------------------------------
+// Spatially partitioned parallel annealing of one placement
+//
+// The grid is cut into tileSize x tileSize tiles, colored like a
+// checkerboard (4 colors by row/column parity). Each temperature
+// runs the 4 colors in turn; within a color, threads anneal
+// disjoint tiles at the same time with swaps / moves to empty
+// cells whose both cells lie in the tile, so a cell and its module
+// are only ever written by one thread. Nets still cross tiles, so
+// each thread computes deltas on its own copy of the packed
+// positions, taken at the start of the phase: exact for its own
+// tiles, one phase stale for modules other threads move. Nothing a
+// thread writes is read by another within a phase; g->modPos is
+// updated between phases. The running cost is resynced with an
+// exact computeCost2D after every temperature, which also feeds
+// best-placement tracking. The tile grid is shifted by a random
+// offset every temperature so modules can cross tile borders.
+//
+// Clique cost model only (HPWL net boxes are shared across tiles);
+// COST_HPWL falls back to simulatedAnnealing2D. Returns the best
+// cost; the best placement is left in g / mod_x / mod_y.
+// threads <= 0: one per hardware thread; tileSize <= 0: default.
+// ----------------------------------------------------------
+#define PSA_DEFAULT_TILE 16
+
+long long partitionedAnnealing2D(Grid* g, Netlist* net, int mod_x[], int mod_y[],
+                                 int moduleCount, const SAParams* params,
+                                 int threads, int tileSize);
+
+#endif
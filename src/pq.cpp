@@ -1,111 +1,153 @@
 #include "pq.h"
-#include <cstdio>
 
-// -------------------------------------------------------------
-// Initialize PQ
-// -------------------------------------------------------------
-void initPQ(PriorityQueue* pq) {
+// =============================================================
+// Indexed max-heap
+// Heap entries carry a copy of their key. Raised keys sift up at
+// once; lowered keys only update key[] and the entry is fixed when
+// it reaches the top, so the many small decreases after a move
+// cost O(1) and a module's repeated changes are sifted only once.
+// Entry priorities are therefore upper bounds of the true keys.
+// =============================================================
+void initIndexedPQ(IndexedPQ* pq, int capacity) {
+    pq->heap = new PQNode[capacity + 1];
+    pq->slot = new int[capacity];
+    pq->key  = new int[capacity];
+    pq->size = 0;
+    pq->capacity = capacity;
+
+    for (int m = 0; m < capacity; m++) {
+        pq->slot[m] = 0;
+        pq->key[m] = 0;
+    }
+}
+
+void freeIndexedPQ(IndexedPQ* pq) {
+    delete[] pq->heap;
+    delete[] pq->slot;
+    delete[] pq->key;
+    pq->heap = nullptr;
+    pq->slot = nullptr;
+    pq->key = nullptr;
     pq->size = 0;
 }
 
-// -------------------------------------------------------------
-// Swap two PQNode elements
-// -------------------------------------------------------------
-void swapNodes(PQNode* a, PQNode* b) {
-    PQNode temp = *a;
-    *a = *b;
-    *b = temp;
+// place node at heap index idx
+static inline void ipqPlace(IndexedPQ* pq, int idx, PQNode node) {
+    pq->heap[idx] = node;
+    pq->slot[node.moduleID] = idx;
 }
 
-// -------------------------------------------------------------
-// Heapify Up (bubble up)
-// -------------------------------------------------------------
-void heapifyUp(PriorityQueue* pq, int idx) {
+static void ipqSiftUp(IndexedPQ* pq, int idx) {
+    PQNode node = pq->heap[idx];
+
     while (idx > 1) {
         int parent = idx / 2;
-        if (pq->heap[parent].priority >= pq->heap[idx].priority)
+        if (pq->heap[parent].priority >= node.priority)
             break;
 
-        swapNodes(&pq->heap[parent], &pq->heap[idx]);
+        ipqPlace(pq, idx, pq->heap[parent]);
         idx = parent;
     }
+    ipqPlace(pq, idx, node);
 }
 
-// -------------------------------------------------------------
-// Insert module into PQ
-// -------------------------------------------------------------
-void pqInsert(PriorityQueue* pq, int moduleID, int priority) {
+static void ipqSiftDown(IndexedPQ* pq, int idx) {
+    PQNode node = pq->heap[idx];
+
+    while (true) {
+        int child = idx * 2;
+        if (child > pq->size) break;
 
-    if (pq->size + 1 >= MAX_NETS) {
-        printf("Priority Queue overflow!\n");
+        if (child + 1 <= pq->size &&
+            pq->heap[child + 1].priority > pq->heap[child].priority)
+            child++;
+
+        if (pq->heap[child].priority <= node.priority)
+            break;
+
+        ipqPlace(pq, idx, pq->heap[child]);
+        idx = child;
+    }
+    ipqPlace(pq, idx, node);
+}
+
+void ipqInsert(IndexedPQ* pq, int moduleID, int key) {
+    if (pq->slot[moduleID] != 0) {
+        ipqSet(pq, moduleID, key);
         return;
     }
 
+    pq->key[moduleID] = key;
     pq->size++;
     pq->heap[pq->size].moduleID = moduleID;
-    pq->heap[pq->size].priority = priority;
-
-    heapifyUp(pq, pq->size);
+    pq->heap[pq->size].priority = key;
+    ipqSiftUp(pq, pq->size);
 }
 
-// -------------------------------------------------------------
-// Heapify down after extracting max
-// -------------------------------------------------------------
-void heapifyDown(PriorityQueue* pq, int idx) {
-    while (true) {
-        int left = idx * 2;
-        int right = left + 1;
-        int largest = idx;
-
-        if (left <= pq->size &&
-            pq->heap[left].priority > pq->heap[largest].priority)
-            largest = left;
+void ipqSet(IndexedPQ* pq, int moduleID, int key) {
+    pq->key[moduleID] = key;
 
-        if (right <= pq->size &&
-            pq->heap[right].priority > pq->heap[largest].priority)
-            largest = right;
-
-        if (largest == idx)
-            break;
-
-        swapNodes(&pq->heap[idx], &pq->heap[largest]);
-        idx = largest;
+    int idx = pq->slot[moduleID];
+    if (idx != 0 && key > pq->heap[idx].priority) {
+        pq->heap[idx].priority = key;
+        ipqSiftUp(pq, idx);
     }
 }
 
-// -------------------------------------------------------------
-// Extract max-priority MODULE
-// -------------------------------------------------------------
-PQNode pqExtractMax(PriorityQueue* pq) {
-    if (pq->size == 0) {
-        PQNode empty = {-1, -1};
-        return empty;
+// sink stale entries until the top holds its true key
+static void ipqSettleTop(IndexedPQ* pq) {
+    while (pq->size > 0) {
+        PQNode* top = &pq->heap[1];
+        int key = pq->key[top->moduleID];
+        if (top->priority == key) return;
+
+        top->priority = key;
+        ipqSiftDown(pq, 1);
     }
+}
 
-    PQNode maxNode = pq->heap[1];
+void ipqAdd(IndexedPQ* pq, int moduleID, int delta) {
+    ipqSet(pq, moduleID, pq->key[moduleID] + delta);
+}
 
-    pq->heap[1] = pq->heap[pq->size];
-    pq->size--;
+int ipqExtractMax(IndexedPQ* pq) {
+    ipqSettleTop(pq);
+    if (pq->size == 0) return -1;
 
-    heapifyDown(pq, 1);
+    int top = pq->heap[1].moduleID;
+    pq->slot[top] = 0;
 
-    return maxNode;
+    PQNode last = pq->heap[pq->size--];
+    if (pq->size > 0) {
+        ipqPlace(pq, 1, last);
+        ipqSiftDown(pq, 1);
+    }
+    return top;
 }
 
-// -------------------------------------------------------------
-// Peek at highest-priority module
-// -------------------------------------------------------------
-PQNode pqPeek(PriorityQueue* pq) {
-    if (pq->size == 0) {
-        PQNode empty = {-1, -1};
-        return empty;
-    }
-    return pq->heap[1];
+int ipqPeek(IndexedPQ* pq) {
+    ipqSettleTop(pq);
+    return (pq->size == 0) ? -1 : pq->heap[1].moduleID;
 }
 
-// -------------------------------------------------------------
-// Check if empty
-// -------------------------------------------------------------
-int pqIsEmpty(PriorityQueue* pq) {
+int ipqIsEmpty(IndexedPQ* pq) {
     return (pq->size == 0);
 }
+
+void ipqRequeue(IndexedPQ* pq, const int modules[], int count) {
+    int added = 0;
+    for (int i = 0; i < count; i++) {
+        int m = modules[i];
+        if (pq->slot[m] != 0) continue;
+
+        pq->size++;
+        pq->heap[pq->size].moduleID = m;
+        pq->heap[pq->size].priority = pq->key[m];
+        pq->slot[m] = pq->size;
+        added++;
+    }
+
+    if (added == 0) return;
+    for (int idx = pq->size / 2; idx >= 1; idx--)
+        ipqSiftDown(pq, idx);
+}
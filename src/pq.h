@@ -1,22 +1,41 @@
 #ifndef PQ_H
 #define PQ_H
 
-#define MAX_NETS 200000   // treat as MAX_MODULES
-
 struct PQNode {
     int moduleID;   // previously netID
     int priority;   // local cost (higher = more critical)
 };
 
-struct PriorityQueue {
-    PQNode heap[MAX_NETS];
+// -------------------------------------------------------------
+// Indexed max-heap over module IDs [0, capacity)
+// slot[] tracks where each module sits in the heap, so a key can
+// be raised or lowered in O(log n). Keys are kept for modules
+// that are not queued as well.
+// -------------------------------------------------------------
+struct IndexedPQ {
+    PQNode* heap;   // 1-based (module, key) entries
+    int* slot;      // module -> heap index, 0 = not queued
+    int* key;       // module -> priority (higher = more critical)
     int size;
+    int capacity;
 };
 
-void initPQ(PriorityQueue* pq);
-void pqInsert(PriorityQueue* pq, int moduleID, int priority);
-PQNode pqExtractMax(PriorityQueue* pq);
-PQNode pqPeek(PriorityQueue* pq);
-int pqIsEmpty(PriorityQueue* pq);
+void initIndexedPQ(IndexedPQ* pq, int capacity);
+void freeIndexedPQ(IndexedPQ* pq);
+
+// Queue module with the given key (or update it if already queued)
+void ipqInsert(IndexedPQ* pq, int moduleID, int key);
+// Raise/lower a module's key; a queued module moves to its new rank,
+// an unqueued one only has its key updated (used when requeued)
+void ipqSet(IndexedPQ* pq, int moduleID, int key);
+void ipqAdd(IndexedPQ* pq, int moduleID, int delta);
+
+// Remove and return the top module (-1 if empty)
+int ipqExtractMax(IndexedPQ* pq);
+int ipqPeek(IndexedPQ* pq);
+int ipqIsEmpty(IndexedPQ* pq);
+
+// Queue every listed module that is not queued (O(n) heapify)
+void ipqRequeue(IndexedPQ* pq, const int modules[], int count);
 
 #endif
@@ -1,8 +1,7 @@
-#include <cstdlib>
-#include <ctime>
 #include <cstdio>
 #include "random2D.h"
 #include "grid.h"
+#include "rng.h"
 
 void randomInitialPlacement2D(Grid* g, int moduleCount, int mod_x[], int mod_y[]) {
     if (!g) {
@@ -17,9 +16,6 @@ void randomInitialPlacement2D(Grid* g, int moduleCount, int mod_x[], int mod_y[]
         return;
     }
 
-    // Seed RNG (do once ideally)
-    srand(time(NULL));
-
     // Temporary array of all grid indices (0..rows*cols - 1)
     int *indices = new int[totalCells];
     for (int i = 0; i < totalCells; i++) {
@@ -27,8 +23,9 @@ void randomInitialPlacement2D(Grid* g, int moduleCount, int mod_x[], int mod_y[]
     }
 
     // Fisher–Yates shuffle of available grid positions
+    Rng* rng = threadRng();
     for (int i = totalCells - 1; i > 0; i--) {
-        int j = rand() % (i + 1);
+        int j = (int)rngBounded(rng, (uint32_t)(i + 1));
 
         int temp = indices[i];
         indices[i] = indices[j];
@@ -43,7 +40,7 @@ void randomInitialPlacement2D(Grid* g, int moduleCount, int mod_x[], int mod_y[]
         int c = idx % g->cols;
 
         // Assign into grid
-        g->cells[idx] = m;
+        placeModuleAt(g, m, r, c);
 
         // Update module lookup tables
         mod_x[m] = r;
@@ -52,3 +49,79 @@ void randomInitialPlacement2D(Grid* g, int moduleCount, int mod_x[], int mod_y[]
 
     delete[] indices;
 }
+
+// ------------------------------------------------------------
+// Warm-start placement: keep every module whose initial (r,c)
+// is inside the grid and free (fixed modules claim cells first),
+// then scatter the remaining modules over the free cells.
+// A fixed module without a usable cell is unfixed with a warning.
+// ------------------------------------------------------------
+int warmStartPlacement2D(Grid* g, int moduleCount, int mod_x[], int mod_y[], char isFixed[]) {
+    if (!g) {
+        printf("Error: Grid is NULL\n");
+        return 0;
+    }
+
+    int totalCells = g->rows * g->cols;
+
+    if (moduleCount > totalCells) {
+        printf("Error: Not enough grid cells for all modules\n");
+        return 0;
+    }
+
+    int kept = 0;
+
+    // pass 0: fixed modules, pass 1: movable modules
+    for (int pass = 0; pass < 2; pass++) {
+        for (int m = 0; m < moduleCount; m++) {
+            int fixedModule = isFixed && isFixed[m];
+            if (fixedModule != (pass == 0)) continue;
+
+            int r = mod_x[m];
+            int c = mod_y[m];
+            int idx = linearIndex(g, r, c);
+
+            if (idx >= 0 && g->cells[idx] == EMPTY_CELL) {
+                placeModuleAt(g, m, r, c);
+                kept++;
+                continue;
+            }
+
+            if (fixedModule) {
+                printf("WARNING: Fixed module %d has no usable cell (%d,%d); treating as movable.\n",
+                       m, r, c);
+                isFixed[m] = 0;
+            }
+            mod_x[m] = -1;
+            mod_y[m] = -1;
+        }
+    }
+
+    // collect and shuffle the free cells
+    int freeCount = g->freeCount;
+    int* freeCells = new int[totalCells];
+    for (int i = 0; i < freeCount; i++) freeCells[i] = g->freeSites[i];
+
+    Rng* rng = threadRng();
+    for (int i = freeCount - 1; i > 0; i--) {
+        int j = (int)rngBounded(rng, (uint32_t)(i + 1));
+
+        int temp = freeCells[i];
+        freeCells[i] = freeCells[j];
+        freeCells[j] = temp;
+    }
+
+    // scatter the unplaced modules
+    int next = 0;
+    for (int m = 0; m < moduleCount; m++) {
+        if (mod_x[m] >= 0) continue;
+
+        int idx = freeCells[next++];
+        mod_x[m] = idx / g->cols;
+        mod_y[m] = idx % g->cols;
+        placeModuleAt(g, m, mod_x[m], mod_y[m]);
+    }
+
+    delete[] freeCells;
+    return kept;
+}
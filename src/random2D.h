@@ -7,4 +7,11 @@
 // moduleCount must be <= rows*cols
 void randomInitialPlacement2D(Grid* g, int moduleCount, int mod_x[], int mod_y[]);
 
+// Warm-start placement from initial coordinates (e.g. a blocks file).
+// mod_x/mod_y hold the initial (row, col) per module, -1 = unplaced;
+// isFixed (nullptr = none fixed) marks pinned modules, which get their
+// cells first. Modules without a free in-grid cell are placed randomly.
+// The grid must be clear. Returns the number of modules kept in place.
+int warmStartPlacement2D(Grid* g, int moduleCount, int mod_x[], int mod_y[], char isFixed[]);
+
 #endif
@@ -0,0 +1,169 @@
+#include <cstdio>
+#include <cstdlib>
+#include "reorder.h"
+#include "netlist.h"
+#include "grid.h"
+
+// ----------------------------------------------------------
+// Clique degree of every module (sum of fanout - 1 over its
+// nets), without building the clique adjacency
+// ----------------------------------------------------------
+static void computeCliqueDegrees(const Netlist* net, long long degree[]) {
+    for (int m = 0; m < net->moduleCount; m++) {
+        degree[m] = 0;
+        for (int k = net->modOffsets[m]; k < net->modOffsets[m + 1]; k++)
+            degree[m] += netFanout(net, net->modNets[k]) - 1;
+    }
+}
+
+// qsort on (degree << 32 | id) keys: by degree, ties by ID
+static int compareKeys(const void* a, const void* b) {
+    long long ka = *(const long long*)a;
+    long long kb = *(const long long*)b;
+    return (ka > kb) - (ka < kb);
+}
+
+// ----------------------------------------------------------
+// BFS / RCM ordering over the hypergraph
+//
+// Each net is expanded once, when the first of its modules is
+// dequeued, so the whole pass is O(pins) plus the sorts. Every
+// component starts from its lowest-degree module (a cheap
+// peripheral-node heuristic); RCM enqueues the newly reached
+// modules of a net by increasing degree and reverses at the end.
+// ----------------------------------------------------------
+void computeModuleOrder(const Netlist* net, int mode, int order[], int rank[]) {
+    int moduleCount = net->moduleCount;
+
+    if (mode == REORDER_NONE) {
+        for (int m = 0; m < moduleCount; m++) {
+            order[m] = m;
+            rank[m] = m;
+        }
+        return;
+    }
+
+    long long* degree = new long long[moduleCount];
+    computeCliqueDegrees(net, degree);
+
+    // start candidates: all modules by increasing degree
+    long long* starts = new long long[moduleCount];
+    for (int m = 0; m < moduleCount; m++)
+        starts[m] = (degree[m] << 32) | m;
+    qsort(starts, moduleCount, sizeof(long long), compareKeys);
+
+    char* netDone = new char[net->netCount];
+    for (int n = 0; n < net->netCount; n++) netDone[n] = 0;
+
+    for (int m = 0; m < moduleCount; m++) rank[m] = -1;
+
+    // order[] doubles as the BFS queue
+    int head = 0, tail = 0;
+    long long* batch = new long long[moduleCount];
+
+    for (int s = 0; s < moduleCount; s++) {
+        int start = (int)(starts[s] & 0xffffffffLL);
+        if (rank[start] >= 0) continue;
+
+        rank[start] = tail;
+        order[tail++] = start;
+
+        while (head < tail) {
+            int m = order[head++];
+
+            for (int k = net->modOffsets[m]; k < net->modOffsets[m + 1]; k++) {
+                int n = net->modNets[k];
+                if (netDone[n]) continue;
+                netDone[n] = 1;
+
+                // newly reached modules of this net
+                int count = 0;
+                for (int p = net->netOffsets[n]; p < net->netOffsets[n + 1]; p++) {
+                    int b = net->netPins[p];
+                    if (rank[b] != -1) continue;
+                    rank[b] = -2;   // queued
+                    batch[count++] = (mode == REORDER_RCM) ? ((degree[b] << 32) | b) : b;
+                }
+
+                if (mode == REORDER_RCM)
+                    qsort(batch, count, sizeof(long long), compareKeys);
+
+                for (int i = 0; i < count; i++) {
+                    int b = (int)(batch[i] & 0xffffffffLL);
+                    rank[b] = tail;
+                    order[tail++] = b;
+                }
+            }
+        }
+    }
+
+    // reverse Cuthill-McKee
+    if (mode == REORDER_RCM) {
+        for (int i = 0, j = moduleCount - 1; i < j; i++, j--) {
+            int t = order[i];
+            order[i] = order[j];
+            order[j] = t;
+        }
+    }
+
+    for (int i = 0; i < moduleCount; i++) rank[order[i]] = i;
+
+    delete[] degree;
+    delete[] starts;
+    delete[] netDone;
+    delete[] batch;
+}
+
+// ----------------------------------------------------------
+// Relabel the pins and rebuild the hypergraph
+// ----------------------------------------------------------
+Netlist* permuteNetlist(const Netlist* net, const int rank[]) {
+    int pinCount = net->netOffsets[net->netCount];
+
+    int* pins = new int[pinCount > 0 ? pinCount : 1];
+    for (int p = 0; p < pinCount; p++)
+        pins[p] = rank[net->netPins[p]];
+
+    Netlist* out = initNetlistFromNets(net->moduleCount, net->netCount,
+                                       net->netOffsets, pins, net->netWeights);
+    delete[] pins;
+    return out;
+}
+
+// ----------------------------------------------------------
+// Per-module array permutation
+// ----------------------------------------------------------
+void permuteModuleInts(int a[], const int order[], int moduleCount) {
+    int* tmp = new int[moduleCount];
+    for (int i = 0; i < moduleCount; i++) tmp[i] = a[order[i]];
+    for (int i = 0; i < moduleCount; i++) a[i] = tmp[i];
+    delete[] tmp;
+}
+
+void unpermuteModuleInts(int a[], const int order[], int moduleCount) {
+    int* tmp = new int[moduleCount];
+    for (int i = 0; i < moduleCount; i++) tmp[order[i]] = a[i];
+    for (int i = 0; i < moduleCount; i++) a[i] = tmp[i];
+    delete[] tmp;
+}
+
+void permuteModuleChars(char a[], const int order[], int moduleCount) {
+    char* tmp = new char[moduleCount];
+    for (int i = 0; i < moduleCount; i++) tmp[i] = a[order[i]];
+    for (int i = 0; i < moduleCount; i++) a[i] = tmp[i];
+    delete[] tmp;
+}
+
+// ----------------------------------------------------------
+// Relabel grid cells
+// ----------------------------------------------------------
+void relabelGrid(Grid* g, const int map[]) {
+    if (!g) return;
+
+    int n = g->rows * g->cols;
+    for (int i = 0; i < n; i++) {
+        if (g->cells[i] != EMPTY_CELL) g->cells[i] = map[g->cells[i]];
+    }
+
+    if (g->modPos) initGridPositions(g, g->moduleCount);
+}
@@ -0,0 +1,35 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "netlist.h"
+#include "grid.h"
+
+// ----------------------------------------------------------
+// Locality-improving module renumbering
+//
+// order[newID] = oldID, rank[oldID] = newID.
+// Connected modules get nearby IDs, so the CSR rows and the
+// placement arrays are read close together in the cost code.
+// ----------------------------------------------------------
+
+#define REORDER_NONE 0
+#define REORDER_BFS  1   // breadth-first over module -> net -> module
+#define REORDER_RCM  2   // reverse Cuthill-McKee (BFS by increasing degree, reversed)
+
+// Compute order[] and rank[] (both size moduleCount) for the hypergraph
+void computeModuleOrder(const Netlist* net, int mode, int order[], int rank[]);
+
+// New netlist with every pin relabeled through rank[] (nets keep their
+// order and weights). Clique adjacency is not built.
+Netlist* permuteNetlist(const Netlist* net, const int rank[]);
+
+// Per-module arrays: a[newID] = a[order[newID]] / back to old IDs
+void permuteModuleInts(int a[], const int order[], int moduleCount);
+void unpermuteModuleInts(int a[], const int order[], int moduleCount);
+void permuteModuleChars(char a[], const int order[], int moduleCount);
+
+// Relabel every occupied grid cell through map[] (rank[] or order[])
+// and rebuild the packed position store if it is active
+void relabelGrid(Grid* g, const int map[]);
+
+#endif
@@ -0,0 +1,70 @@
+#include <atomic>
+#include "rng.h"
+
+static uint64_t globalSeed = 0x853c49e6748fea9bULL;
+static std::atomic<uint64_t> nextStream(1);   // stream 0 = main thread
+
+static thread_local Rng localRng;
+static thread_local int localSeeded = 0;
+
+// ----------------------------------------------------------
+// splitmix64: expands a 64-bit seed into the xoshiro state
+// ----------------------------------------------------------
+static uint64_t splitmix64(uint64_t* x) {
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Advance by 2^128 draws
+static void rngJump(Rng* rng) {
+    static const uint64_t JUMP[4] = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+        0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+    };
+
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (JUMP[i] & (1ULL << b)) {
+                s0 ^= rng->s[0];
+                s1 ^= rng->s[1];
+                s2 ^= rng->s[2];
+                s3 ^= rng->s[3];
+            }
+            rngNext(rng);
+        }
+    }
+
+    rng->s[0] = s0;
+    rng->s[1] = s1;
+    rng->s[2] = s2;
+    rng->s[3] = s3;
+}
+
+void seedRng(Rng* rng, uint64_t seed, uint64_t stream) {
+    uint64_t x = seed;
+    for (int i = 0; i < 4; i++) rng->s[i] = splitmix64(&x);
+
+    for (uint64_t k = 0; k < stream; k++) rngJump(rng);
+}
+
+void setRandomSeed(uint64_t seed) {
+    globalSeed = seed;
+    seedThreadRng(0);
+}
+
+uint64_t getRandomSeed() {
+    return globalSeed;
+}
+
+void seedThreadRng(uint64_t stream) {
+    seedRng(&localRng, globalSeed, stream);
+    localSeeded = 1;
+}
+
+Rng* threadRng() {
+    if (!localSeeded) seedThreadRng(nextStream++);
+    return &localRng;
+}
@@ -0,0 +1,77 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+
+// ----------------------------------------------------------
+// xoshiro256** generator
+//
+// Every thread draws from its own stream. Streams come from one
+// user seed: the state is expanded with splitmix64 and stream k
+// is that state advanced by k jumps of 2^128, so streams never
+// overlap and a run is reproducible from (seed, thread index).
+// ----------------------------------------------------------
+struct Rng {
+    uint64_t s[4];
+};
+
+// Seed rng as stream 'stream' of 'seed'
+void seedRng(Rng* rng, uint64_t seed, uint64_t stream);
+
+// Set the global seed and reseed the calling thread as stream 0
+void setRandomSeed(uint64_t seed);
+uint64_t getRandomSeed();
+
+// Seed the calling thread's generator as stream 'stream' of the
+// global seed (worker threads call this with their index; threads
+// that don't get the next free stream on first use)
+void seedThreadRng(uint64_t stream);
+
+// The calling thread's generator
+Rng* threadRng();
+
+static inline uint64_t rotl64(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t rngNext(Rng* rng) {
+    uint64_t* s = rng->s;
+    uint64_t result = rotl64(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl64(s[3], 45);
+
+    return result;
+}
+
+// Unbiased integer in [0, n) (Lemire's multiply-and-reject)
+static inline uint32_t rngBounded(Rng* rng, uint32_t n) {
+    uint64_t m = (uint64_t)(uint32_t)(rngNext(rng) >> 32) * n;
+    uint32_t low = (uint32_t)m;
+
+    if (low < n) {
+        uint32_t threshold = (0u - n) % n;
+        while (low < threshold) {
+            m = (uint64_t)(uint32_t)(rngNext(rng) >> 32) * n;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+// Integer in [min, max]
+static inline int rngRange(Rng* rng, int min, int max) {
+    return min + (int)rngBounded(rng, (uint32_t)(max - min) + 1u);
+}
+
+// Double in [0, 1)
+static inline double rngUniform(Rng* rng) {
+    return (double)(rngNext(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+#endif
@@ -1,147 +1,377 @@
 #include <cstdio>
 #include <cmath>
 #include <cstdlib>
+#include <climits>
 
 #include "sa_timing.h"
 #include "netlist.h"
 #include "grid.h"
 #include "cost2D.h"
+#include "hpwl2D.h"
 #include "move2D.h"
 #include "pq.h"
+#include "best_state.h"
+#include "rng.h"
+#include "schedule.h"
+
+#define SCHED_SAMPLE_MOVES 1000   // random swaps sampled for T0
 
 // ----------------------------------------------------------
 // Metropolis acceptance function
 // ----------------------------------------------------------
-static int acceptMove2D(int delta, double T) {
+static int acceptMove2D(Rng* rng, int delta, double T) {
     if (delta <= 0) return 1;
 
     double prob = exp(-((double)delta) / T);
-    double r = (double)rand() / RAND_MAX;
+    double r = rngUniform(rng);
 
     return (r < prob);
 }
 
 // ----------------------------------------------------------
 // Local cost contribution of a module
-// (sum of distances to all neighbors)
+// (weighted sum of distances to all neighbors,
+//  read from the grid's packed position store)
 // ----------------------------------------------------------
-static int computeModuleLocalCost2D(Netlist* net, int mod_x[], int mod_y[], int module) {
+static int computeModuleLocalCost2D(Netlist* net, const unsigned int pos[], int module) {
     int cost = 0;
-    int x1 = mod_x[module];
-    int y1 = mod_y[module];
+    unsigned int p1 = pos[module];
+    int x1 = POS_ROW(p1);
+    int y1 = POS_COL(p1);
 
-    Node* curr = net->adj[module];
+    for (int e = net->offsets[module]; e < net->offsets[module + 1]; e++) {
+        unsigned int p2 = pos[net->neighbors[e]];
 
-    while (curr != NULL) {
-        int neigh = curr->module;
-        int x2 = mod_x[neigh];
-        int y2 = mod_y[neigh];
+        cost += net->edgeWeights[e] * manhattanDistance2D(x1, y1, POS_ROW(p2), POS_COL(p2));
+    }
 
-        cost += manhattanDistance2D(x1, y1, x2, y2);
+    return cost;
+}
 
-        curr = curr->next;
+// ----------------------------------------------------------
+// Queue all movable modules by local cost
+// Higher cost = more critical; fixed modules are left out
+// (hpwl != nullptr: local cost is the HPWL of the module's nets)
+// ----------------------------------------------------------
+static void initCriticality2D(Netlist* net,
+                              const unsigned int pos[],
+                              HPWLState2D* hpwl,
+                              const int movable[], int movableCount,
+                              IndexedPQ* pq)
+{
+    for (int i = 0; i < movableCount; i++) {
+        int m = movable[i];
+        int localCost = hpwl
+            ? computeModuleLocalHPWL2D(hpwl, net, m)
+            : computeModuleLocalCost2D(net, pos, m);
+        ipqInsert(pq, m, localCost);
     }
+}
 
-    return cost;
+// ----------------------------------------------------------
+// Clique model: module has moved from (old_x, old_y) to pos[module].
+// Shift the keys of its movable neighbors by the change of the
+// connecting edge and recompute the module's own key in the same
+// pass. 'other' is the swap partner (also moved, recomputed by its
+// own call) or -1.
+// ----------------------------------------------------------
+static void updateCliqueCriticality2D(Netlist* net, const unsigned int pos[],
+                                      const char isFixed[], IndexedPQ* pq,
+                                      int module, int other, int old_x, int old_y)
+{
+    unsigned int p = pos[module];
+    int new_x = POS_ROW(p);
+    int new_y = POS_COL(p);
+    int key = 0;
+
+    for (int e = net->offsets[module]; e < net->offsets[module + 1]; e++) {
+        int nb = net->neighbors[e];
+        int w  = net->edgeWeights[e];
+
+        unsigned int q = pos[nb];
+        int x = POS_ROW(q);
+        int y = POS_COL(q);
+
+        int dNew = abs(x - new_x) + abs(y - new_y);
+        key += w * dNew;
+
+        if (nb == other || (isFixed && isFixed[nb])) continue;
+
+        int dOld = abs(x - old_x) + abs(y - old_y);
+        if (dNew != dOld) ipqAdd(pq, nb, w * (dNew - dOld));
+    }
+
+    ipqSet(pq, module, key);
 }
 
 // ----------------------------------------------------------
-// Build Priority Queue of modules sorted by local cost
-// Higher cost = more critical
+// HPWL model: spread the HPWL change of every net touched by the
+// evaluated move over the keys of its movable pins
+// (call before commitHPWLMove2D)
 // ----------------------------------------------------------
-static void buildModulePriorityQueue(Netlist* net,
-                                     int mod_x[], int mod_y[],
-                                     PriorityQueue* pq)
+static void updateHPWLCriticality2D(HPWLState2D* hpwl, Netlist* net,
+                                    const char isFixed[], IndexedPQ* pq)
 {
-    initPQ(pq);
+    for (int i = 0; i < hpwl->touchedCount; i++) {
+        int change = touchedNetDeltaHPWL2D(hpwl, net, i);
+        if (change == 0) continue;
+
+        int n = hpwl->touchedNets[i];
+        for (int k = net->netOffsets[n]; k < net->netOffsets[n + 1]; k++) {
+            int m = net->netPins[k];
+            if (!isFixed || !isFixed[m]) ipqAdd(pq, m, change);
+        }
+    }
+}
 
-    for (int m = 0; m < net->moduleCount; m++) {
-        int localCost = computeModuleLocalCost2D(net, mod_x, mod_y, m);
-        pqInsert(pq, m, localCost);
+// ----------------------------------------------------------
+// Deltas of random swaps at the current placement (not applied),
+// used to derive the starting temperature. Returns the count.
+// ----------------------------------------------------------
+static int sampleSwapDeltas2D(Netlist* net, const unsigned int pos[],
+                              HPWLState2D* hpwl, int mod_x[], int mod_y[],
+                              const int movable[], int movableCount,
+                              int deltas[], int count)
+{
+    for (int i = 0; i < count; i++) {
+        int m1, m2;
+        generateRandomMovablePair(movable, movableCount, &m1, &m2);
+
+        deltas[i] = hpwl
+            ? computeDeltaHPWLSwap2D(hpwl, net, mod_x, mod_y, m1, m2)
+            : computeDeltaCostSwapPacked2D(net, pos, m1, m2);
     }
+    return count;
+}
+
+// ----------------------------------------------------------
+// Lower a shared cost to cost if it is better (CAS-min);
+// returns the shared value afterwards
+// ----------------------------------------------------------
+static long long publishMin(std::atomic<long long>* shared, long long cost) {
+    long long seen = shared->load(std::memory_order_relaxed);
+    while (cost < seen &&
+           !shared->compare_exchange_weak(seen, cost, std::memory_order_relaxed))
+        ;
+    return (cost < seen) ? cost : seen;
+}
+
+void initSASharedBest(SASharedBest* shared) {
+    shared->cost.store(LLONG_MAX);
+    for (int t = 0; t < SA_MAX_STAGES; t++) shared->stageBest[t].store(LLONG_MAX);
+}
+
+// ----------------------------------------------------------
+// Default annealer options
+// ----------------------------------------------------------
+void initSAParams(SAParams* params) {
+    params->costModel = COST_CLIQUE;
+    params->isFixed = nullptr;
+    params->moveGen = MOVE_GLOBAL;
+    params->emptyMoveRate = 0.0;
+    params->t0Scale = 1.0;
+    params->shared = nullptr;
+    params->verbose = 1;
 }
 
 // ----------------------------------------------------------
 // Main 2D Simulated Annealing routine
 // ----------------------------------------------------------
-void simulatedAnnealing2D(Grid* g, Netlist* net,
-                          int mod_x[], int mod_y[],
-                          int moduleCount)
+long long simulatedAnnealing2D(Grid* g, Netlist* net,
+                               int mod_x[], int mod_y[],
+                               int moduleCount,
+                               const SAParams* params)
 {
-    // SA parameters (tune if needed)
-    double T      = 1000.0;
-    double Tmin   = 0.1;
-    double alpha  = 0.95;
-    int iterationsPerT = moduleCount;  // inner loop per temperature
-
-    int currentCost = computeCost2D(net, mod_x, mod_y);
-    int bestCost    = currentCost;
-
-    // store best placement
-    int* best_x = new int[moduleCount];
-    int* best_y = new int[moduleCount];
-
-    for (int i = 0; i < moduleCount; i++) {
-        best_x[i] = mod_x[i];
-        best_y[i] = mod_y[i];
+    SAParams defaults;
+    initSAParams(&defaults);
+    if (!params) params = &defaults;
+
+    // Moves only ever draw from the movable modules
+    int* movable = new int[moduleCount];
+    int movableCount = buildMovableList(params->isFixed, moduleCount, movable);
+
+    if (movableCount < 2) {
+        printf("Nothing to anneal: %d movable module(s).\n", movableCount);
+        delete[] movable;
+        return (params->costModel == COST_HPWL) ? computeCostHPWL2D(net, mod_x, mod_y)
+                                                : computeCost2D(net, mod_x, mod_y);
     }
 
-    printf("Initial 2D Cost: %d\n", currentCost);
+    // Packed (row, col) store kept by the grid next to mod_x/mod_y;
+    // the clique kernels read neighbor positions from it
+    initGridPositions(g, moduleCount);
+
+    // HPWL mode keeps per-net bounding boxes alongside the placement
+    HPWLState2D* hpwl = nullptr;
+    if (params->costModel == COST_HPWL)
+        hpwl = initHPWLState2D(net, mod_x, mod_y);
+
+    int iterationsPerT = movableCount;  // inner loop per temperature
+
+    long long currentCost = hpwl ? computeCostHPWL2D(net, mod_x, mod_y)
+                                 : computeCost2D(net, mod_x, mod_y);
+    long long bestCost    = currentCost;
 
-    PriorityQueue pq;
+    // Schedule: T0 from the spread of random swap deltas, then
+    // alpha and the stop point follow the acceptance statistics
+    int sampleCount = movableCount < SCHED_SAMPLE_MOVES ? movableCount : SCHED_SAMPLE_MOVES;
+    int* deltas = new int[sampleCount];
+    sampleSwapDeltas2D(net, g->modPos, hpwl, mod_x, mod_y,
+                       movable, movableCount, deltas, sampleCount);
 
-    while (T > Tmin) {
+    AnnealSchedule sched;
+    initSchedule(&sched, params->t0Scale * initialTemperature(deltas, sampleCount),
+                 net->netCount);
+    delete[] deltas;
 
-        // Rebuild criticality PQ for this temperature
-        buildModulePriorityQueue(net, mod_x, mod_y, &pq);
+    // track the best placement through an undo journal
+    // (no full copy per improving move)
+    BestState2D best;
+    initBestState2D(&best, moduleCount, 0);
+
+    if (params->verbose)
+        printf("Initial 2D Cost: %lld, T0 = %.2f\n", currentCost, sched.T / WEIGHT_ONE);
+
+    // Criticality queue: keys follow accepted moves; modules picked
+    // from it rejoin at the next temperature
+    IndexedPQ pq;
+    initIndexedPQ(&pq, moduleCount);
+    initCriticality2D(net, g->modPos, hpwl, movable, movableCount, &pq);
+
+    Rng* rng = threadRng();
+
+    // Range limit of the window generator (starts at the whole grid)
+    int window = params->moveGen == MOVE_WINDOW;
+    int cutOff = 0;
+    double rlim = (g->rows > g->cols) ? g->rows : g->cols;
+
+    while (!sched.done) {
+        double T = sched.T;
+
+        // Requeue the modules picked during the last temperature
+        ipqRequeue(&pq, movable, movableCount);
+        int accepted = 0;
 
         for (int iter = 0; iter < iterationsPerT; iter++) {
 
             int m1, m2;
+            int tr, tc;
 
             // 50% chance: PQ-guided (critical module)
-            int usePQ = (rand() % 100) < 50;
-
-            if (usePQ && !pqIsEmpty(&pq)) {
-                PQNode top = pqExtractMax(&pq);
-                m1 = top.moduleID;
-
-                // choose random partner
-                m2 = randInt2D(0, moduleCount - 1);
+            int usePQ = (int)(rngNext(rng) >> 63);
+
+            // Move to an empty cell (free-site index), else swap
+            int toEmpty = params->emptyMoveRate > 0.0 && g->freeCount > 0 &&
+                          rngUniform(rng) < params->emptyMoveRate;
+
+            if (toEmpty) {
+                if (usePQ && !ipqIsEmpty(&pq))
+                    m1 = ipqExtractMax(&pq);
+                else
+                    m1 = movable[randInt2D(0, movableCount - 1)];
+
+                int found = window
+                    ? sampleFreeSiteNear2D(g, mod_x[m1], mod_y[m1], (int)rlim, &tr, &tc)
+                    : sampleFreeSite2D(g, &tr, &tc);
+                if (!found) continue;
+                m2 = -1;
+            } else if (window) {
+                // PQ-guided or random module, partner from its window
+                if (usePQ && !ipqIsEmpty(&pq))
+                    m1 = ipqExtractMax(&pq);
+                else
+                    m1 = movable[randInt2D(0, movableCount - 1)];
+
+                if (!generateWindowPartner2D(g, mod_x, mod_y, params->isFixed,
+                                             m1, (int)rlim, &m2))
+                    continue;
+            } else if (usePQ && !ipqIsEmpty(&pq)) {
+                m1 = ipqExtractMax(&pq);
+
+                // choose random movable partner
+                m2 = movable[randInt2D(0, movableCount - 1)];
                 while (m2 == m1) {
-                    m2 = randInt2D(0, moduleCount - 1);
+                    m2 = movable[randInt2D(0, movableCount - 1)];
                 }
             } else {
                 // fully random swap
-                generateRandomModulePair(moduleCount, &m1, &m2);
+                generateRandomMovablePair(movable, movableCount, &m1, &m2);
+            }
+
+            int delta;
+
+            if (toEmpty) {
+                delta = hpwl
+                    ? computeDeltaHPWLMove2D(hpwl, net, mod_x, mod_y, m1, tr, tc)
+                    : computeDeltaCostMovePacked2D(net, g->modPos, m1, tr, tc);
+            } else {
+                delta = hpwl
+                    ? computeDeltaHPWLSwap2D(hpwl, net, mod_x, mod_y, m1, m2)
+                    : computeDeltaCostSwapPacked2D(net, g->modPos, m1, m2);
             }
 
-            int delta = computeDeltaCostSwap2D(net, mod_x, mod_y, m1, m2);
+            if (acceptMove2D(rng, delta, T)) {
+                // apply move / swap
+                if (hpwl) {
+                    updateHPWLCriticality2D(hpwl, net, params->isFixed, &pq);
+                    commitHPWLMove2D(hpwl);
+                }
+
+                int old_x = mod_x[m1];
+                int old_y = mod_y[m1];
+                if (toEmpty)
+                    moveModuleTo(g, mod_x, mod_y, m1, tr, tc);
+                else
+                    applySwapMove2D(g, mod_x, mod_y, m1, m2);
+
+                if (!hpwl) {
+                    // a swap put each module where the other one was
+                    updateCliqueCriticality2D(net, g->modPos, params->isFixed, &pq,
+                                              m1, m2, old_x, old_y);
+                    if (!toEmpty)
+                        updateCliqueCriticality2D(net, g->modPos, params->isFixed, &pq,
+                                                  m2, m1, mod_x[m1], mod_y[m1]);
+                }
 
-            if (acceptMove2D(delta, T)) {
-                // apply swap
-                applySwapMove2D(g, mod_x, mod_y, m1, m2);
                 currentCost += delta;
+                accepted++;
 
                 if (currentCost < bestCost) {
                     bestCost = currentCost;
-                    for (int i = 0; i < moduleCount; i++) {
-                        best_x[i] = mod_x[i];
-                        best_y[i] = mod_y[i];
-                    }
+                    markBest2D(&best);
+                } else if (toEmpty) {
+                    recordMoveBest2D(&best, mod_x, mod_y, m1, old_x, old_y);
+                } else {
+                    recordSwapBest2D(&best, mod_x, mod_y, m1, m2);
                 }
             }
         }
 
-        printf("T = %.2f, Current Cost = %d, Best = %d\n", T, currentCost, bestCost);
-        T = T * alpha;
+        advanceSchedule(&sched, accepted, iterationsPerT, currentCost);
+
+        if (params->verbose)
+            printf("T = %.2f, Current Cost = %lld, Best = %lld, Accepted = %.1f%%\n",
+                   T / WEIGHT_ONE, currentCost, bestCost, 100.0 * sched.acceptRate);
+
+        // Multi-start: publish, and give up if clearly behind
+        if (params->shared && sched.temps <= SA_MAX_STAGES) {
+            publishMin(&params->shared->cost, bestCost);
+            long long stageBest = publishMin(&params->shared->stageBest[sched.temps - 1], bestCost);
+            if (sched.temps >= SA_CUTOFF_MIN_TEMPS &&
+                bestCost > stageBest * (1.0 + SA_CUTOFF_MARGIN)) {
+                cutOff = 1;
+                break;
+            }
+        } else if (params->shared) {
+            publishMin(&params->shared->cost, bestCost);
+        }
+
+        if (window)
+            rlim = updateWindowLimit2D(g, rlim, sched.acceptRate);
     }
 
     // restore best placement
-    for (int i = 0; i < moduleCount; i++) {
-        mod_x[i] = best_x[i];
-        mod_y[i] = best_y[i];
-    }
+    restoreBest2D(&best, mod_x, mod_y);
 
     // rebuild grid according to best placement
     clearGrid(g);
@@ -151,8 +381,14 @@ void simulatedAnnealing2D(Grid* g, Netlist* net,
         placeModuleAt(g, m, r, c);
     }
 
-    printf("Final Best 2D Cost: %d\n", bestCost);
+    if (params->verbose) {
+        printf("Final Best 2D Cost: %lld after %d temperatures%s\n",
+               bestCost, sched.temps, cutOff ? " (cut off)" : "");
+    }
 
-    delete[] best_x;
-    delete[] best_y;
+    freeIndexedPQ(&pq);
+    freeBestState2D(&best);
+    delete[] movable;
+    freeHPWLState2D(hpwl);
+    return bestCost;
 }
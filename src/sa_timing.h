@@ -1,14 +1,66 @@
 #ifndef SA_TIMING_H
 #define SA_TIMING_H
 
+#include <atomic>
 #include "grid.h"
 #include "netlist.h"
 
+// Cost models understood by the annealer
+#define COST_CLIQUE 0   // clique Manhattan sum (cost2D, needs buildCliqueAdjacency)
+#define COST_HPWL   1   // half-perimeter wirelength with cached net boxes (hpwl2D)
+
+// Swap partner generators
+#define MOVE_GLOBAL 0   // partner drawn uniformly from all movable modules
+#define MOVE_WINDOW 1   // partner drawn from a window around the module's
+                        // cell; window adapts toward ~44% acceptance
+
+// Best costs shared by concurrent annealers (lock-free: each run
+// publishes with a CAS-min after every temperature). stageBest[t] is
+// the lowest best cost any run had after t + 1 temperatures, so runs
+// are compared at the same point of their schedules however the
+// threads are scheduled.
+#define SA_MAX_STAGES 1024
+
+struct SASharedBest {
+    std::atomic<long long> cost;
+    std::atomic<long long> stageBest[SA_MAX_STAGES];
+};
+
+// Reset the record (all costs LLONG_MAX)
+void initSASharedBest(SASharedBest* shared);
+
+// A run sharing a record gives up once it has done SA_CUTOFF_MIN_TEMPS
+// temperatures and its best is more than SA_CUTOFF_MARGIN (relative)
+// above the best any run had at the same temperature count
+#define SA_CUTOFF_MIN_TEMPS 50
+#define SA_CUTOFF_MARGIN    0.02
+
+// Annealer options
+struct SAParams {
+    int costModel;         // COST_CLIQUE or COST_HPWL
+    const char* isFixed;   // per module, 1 = pinned (nullptr: all movable)
+    int moveGen;           // MOVE_GLOBAL or MOVE_WINDOW
+    double emptyMoveRate;  // share of moves that relocate a module to an
+                           // empty cell instead of swapping (0: swaps only)
+    double t0Scale;        // factor on the sampled T0 (1: anneal from scratch;
+                           // small values refine an already good placement)
+    SASharedBest* shared;  // multi-start record (nullptr: single run)
+    int verbose;           // print progress every temperature
+};
+
+// Fill params with the defaults (clique cost model, nothing fixed,
+// global swaps only, full T0, single verbose run)
+void initSAParams(SAParams* params);
+
 // Timing-aware 2D simulated annealing
 // - g:       pointer to grid
-// - net:     netlist (adjacency list)
+// - net:     netlist (hypergraph + CSR adjacency)
 // - mod_x/y: module -> (row, col) coordinates
 // - moduleCount: number of modules
-void simulatedAnnealing2D(Grid* g, Netlist* net, int mod_x[], int mod_y[], int moduleCount);
+// - params:  options, or nullptr for defaults
+// Leaves the best placement in g / mod_x / mod_y and returns its cost
+// (a run cut off early returns the best it reached)
+long long simulatedAnnealing2D(Grid* g, Netlist* net, int mod_x[], int mod_y[], int moduleCount,
+                               const SAParams* params = nullptr);
 
 #endif
@@ -0,0 +1,69 @@
+#include <cmath>
+#include "schedule.h"
+
+double initialTemperature(const int deltas[], int count) {
+    if (count < 2) return 1.0;
+
+    double mean = 0.0;
+    for (int i = 0; i < count; i++) mean += deltas[i];
+    mean /= count;
+
+    double var = 0.0;
+    for (int i = 0; i < count; i++) {
+        double d = deltas[i] - mean;
+        var += d * d;
+    }
+    var /= count - 1;
+
+    double T0 = SCHED_T0_SIGMAS * sqrt(var);
+    return (T0 < 1.0) ? 1.0 : T0;
+}
+
+void initSchedule(AnnealSchedule* s, double T0, int netCount) {
+    s->T = T0;
+    s->alpha = 1.0;
+    s->acceptRate = 1.0;
+    s->temps = 0;
+    s->netCount = (netCount > 0) ? netCount : 1;
+    s->done = 0;
+    s->historyCount = 0;
+}
+
+// ----------------------------------------------------------
+// Cooling factor from the acceptance rate
+// ----------------------------------------------------------
+static double pickAlpha(double acceptRate) {
+    if (acceptRate > 0.96) return 0.5;
+    if (acceptRate > 0.8)  return 0.9;
+    if (acceptRate > 0.15) return 0.95;
+    return 0.8;
+}
+
+void advanceSchedule(AnnealSchedule* s, int accepted, int attempted, double cost) {
+    s->acceptRate = attempted ? (double)accepted / attempted : 0.0;
+    s->alpha = pickAlpha(s->acceptRate);
+    s->T *= s->alpha;
+    s->temps++;
+
+    // keep the costs of the last SCHED_STALL_TEMPS + 1 temperatures
+    if (s->historyCount == SCHED_STALL_TEMPS + 1) {
+        for (int i = 1; i <= SCHED_STALL_TEMPS; i++)
+            s->history[i - 1] = s->history[i];
+        s->historyCount--;
+    }
+    s->history[s->historyCount++] = cost;
+
+    // (the floor catches zero-cost placements)
+    if (s->T < SCHED_EXIT_EPS * cost / s->netCount || s->T < 1e-6) {
+        s->done = 1;
+        return;
+    }
+
+    if (s->historyCount == SCHED_STALL_TEMPS + 1 &&
+        s->acceptRate < SCHED_STALL_ACCEPT)
+    {
+        double old = s->history[0];
+        double gain = (old > 0.0) ? (old - cost) / old : 0.0;
+        if (gain < SCHED_STALL_EPS) s->done = 1;
+    }
+}
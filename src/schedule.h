@@ -0,0 +1,43 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+// ----------------------------------------------------------
+// Adaptive annealing schedule (VPR style)
+//
+// - T0 = SCHED_T0_SIGMAS * stddev of sampled move deltas
+// - after each temperature, alpha is picked from the measured
+//   acceptance rate (fast cooling when nearly everything or
+//   nearly nothing is accepted, slow in the useful middle)
+// - stop when T < SCHED_EXIT_EPS * cost / netCount, or when the
+//   cost has improved by less than SCHED_STALL_EPS (relative)
+//   over the last SCHED_STALL_TEMPS temperatures while the
+//   acceptance rate is below SCHED_STALL_ACCEPT
+// ----------------------------------------------------------
+#define SCHED_T0_SIGMAS     20.0
+#define SCHED_EXIT_EPS      0.002
+#define SCHED_STALL_TEMPS   5
+#define SCHED_STALL_EPS     0.001
+#define SCHED_STALL_ACCEPT  0.2
+
+struct AnnealSchedule {
+    double T;
+    double alpha;          // factor used for the last cooling step
+    double acceptRate;     // of the last temperature
+    int temps;             // temperatures completed
+    int netCount;          // for the cost-relative exit temperature
+    int done;
+
+    double history[SCHED_STALL_TEMPS + 1];   // cost after recent temperatures
+    int historyCount;
+};
+
+// Starting temperature from sampled deltas (>= 1 if all deltas are equal)
+double initialTemperature(const int deltas[], int count);
+
+void initSchedule(AnnealSchedule* s, double T0, int netCount);
+
+// Close a temperature: accepted/attempted moves and the cost at its end.
+// Cools T and sets s->done when annealing should stop.
+void advanceSchedule(AnnealSchedule* s, int accepted, int attempted, double cost);
+
+#endif
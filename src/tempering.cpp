@@ -0,0 +1,329 @@
+#include <cstdio>
+#include <cmath>
+
+#include "tempering.h"
+#include "cost2D.h"
+#include "hpwl2D.h"
+#include "move2D.h"
+#include "rng.h"
+#include "schedule.h"
+#include "threads.h"
+
+// ----------------------------------------------------------
+// One placement and everything that moves with it on an exchange
+// ----------------------------------------------------------
+struct Replica {
+    Grid* g;
+    int* mod_x;
+    int* mod_y;
+    HPWLState2D* hpwl;    // HPWL model only
+    long long cost;
+};
+
+// Temperature slot: fixed T, its own RNG and move window, the
+// replica it holds
+struct TemperSlot {
+    double T;
+    Rng rng;
+    double rlim;          // MOVE_WINDOW range limit, adapted per slot
+    Replica* rep;
+    int accepted;         // in the last sweep
+};
+
+static Replica* newReplica(Grid* g, Netlist* net, const int mod_x[], const int mod_y[],
+                           int moduleCount, int costModel)
+{
+    Replica* r = new Replica;
+    r->g = copyGrid(g);
+    r->mod_x = new int[moduleCount];
+    r->mod_y = new int[moduleCount];
+    for (int m = 0; m < moduleCount; m++) {
+        r->mod_x[m] = mod_x[m];
+        r->mod_y[m] = mod_y[m];
+    }
+    initGridPositions(r->g, moduleCount);
+
+    r->hpwl = nullptr;
+    if (costModel == COST_HPWL) {
+        r->hpwl = initHPWLState2D(net, r->mod_x, r->mod_y);
+        r->cost = computeCostHPWL2D(net, r->mod_x, r->mod_y);
+    } else {
+        r->cost = computeCost2D(net, r->mod_x, r->mod_y);
+    }
+    return r;
+}
+
+static void freeReplica(Replica* r) {
+    freeGrid(r->g);
+    delete[] r->mod_x;
+    delete[] r->mod_y;
+    freeHPWLState2D(r->hpwl);
+    delete r;
+}
+
+// ----------------------------------------------------------
+// One sweep of Metropolis moves on the slot's replica
+// ----------------------------------------------------------
+static void sweepSlot(TemperSlot* s, Netlist* net, const SAParams* params,
+                      const int movable[], int movableCount, int moves)
+{
+    Replica* r = s->rep;
+    int window = params->moveGen == MOVE_WINDOW;
+    int rlim = (int)s->rlim;
+
+    // the move generators draw from the thread's stream: run it on
+    // the slot's state so results don't depend on thread placement
+    Rng* rng = threadRng();
+    *rng = s->rng;
+    s->accepted = 0;
+
+    for (int k = 0; k < moves; k++) {
+        int m1 = movable[rngBounded(rng, (uint32_t)movableCount)];
+        int m2 = -1, tr = 0, tc = 0;
+        int delta;
+
+        int toEmpty = params->emptyMoveRate > 0.0 && r->g->freeCount > 0 &&
+                      rngUniform(rng) < params->emptyMoveRate;
+
+        if (toEmpty) {
+            int found = window
+                ? sampleFreeSiteNear2D(r->g, r->mod_x[m1], r->mod_y[m1], rlim, &tr, &tc)
+                : sampleFreeSite2D(r->g, &tr, &tc);
+            if (!found) continue;
+            delta = r->hpwl
+                ? computeDeltaHPWLMove2D(r->hpwl, net, r->mod_x, r->mod_y, m1, tr, tc)
+                : computeDeltaCostMovePacked2D(net, r->g->modPos, m1, tr, tc);
+        } else {
+            if (window) {
+                if (!generateWindowPartner2D(r->g, r->mod_x, r->mod_y, params->isFixed,
+                                             m1, rlim, &m2))
+                    continue;
+            } else {
+                m2 = movable[rngBounded(rng, (uint32_t)movableCount)];
+                if (m2 == m1) continue;
+            }
+            delta = r->hpwl
+                ? computeDeltaHPWLSwap2D(r->hpwl, net, r->mod_x, r->mod_y, m1, m2)
+                : computeDeltaCostSwapPacked2D(net, r->g->modPos, m1, m2);
+        }
+
+        if (delta > 0 && rngUniform(rng) >= exp(-((double)delta) / s->T))
+            continue;
+
+        if (r->hpwl) commitHPWLMove2D(r->hpwl);
+        if (toEmpty)
+            moveModuleTo(r->g, r->mod_x, r->mod_y, m1, tr, tc);
+        else
+            applySwapMove2D(r->g, r->mod_x, r->mod_y, m1, m2);
+
+        r->cost += delta;
+        s->accepted++;
+    }
+
+    s->rng = *rng;
+}
+
+// Sweeps of one round, handed to the worker pool
+struct SweepJob {
+    TemperSlot* slots;
+    int replicas;
+    int workers;
+    Netlist* net;
+    const SAParams* params;
+    const int* movable;
+    int movableCount;
+};
+
+static void sweepWorker(void* ctx, int w) {
+    SweepJob* job = (SweepJob*)ctx;
+    for (int i = w; i < job->replicas; i += job->workers)
+        sweepSlot(&job->slots[i], job->net, job->params,
+                  job->movable, job->movableCount, job->movableCount);
+}
+
+// ----------------------------------------------------------
+// Rung temperatures: the coldest slot at Tcold, each hotter one
+// exp(logGap) above the next, capped at Tmax
+// ----------------------------------------------------------
+static void placeRungs(TemperSlot slots[], int replicas,
+                       double Tcold, double logGap, double Tmax)
+{
+    double T = Tcold;
+    for (int i = replicas - 1; i >= 0; i--) {
+        slots[i].T = (T < Tmax) ? T : Tmax;
+        T *= exp(logGap);
+    }
+}
+
+long long parallelTempering2D(Grid* g, Netlist* net, int mod_x[], int mod_y[],
+                              int moduleCount, const SAParams* params,
+                              int replicas, int rounds)
+{
+    SAParams defaults;
+    initSAParams(&defaults);
+    if (!params) params = &defaults;
+
+    if (replicas <= 0) replicas = hardwareThreads();
+    if (replicas < 2) replicas = 2;
+    if (rounds <= 0) rounds = PT_DEFAULT_ROUNDS;
+
+    int* movable = new int[moduleCount];
+    int movableCount = buildMovableList(params->isFixed, moduleCount, movable);
+
+    // -------------------------------------------------------
+    // Replicas start from the caller's placement
+    // -------------------------------------------------------
+    TemperSlot* slots = new TemperSlot[replicas];
+    for (int i = 0; i < replicas; i++) {
+        slots[i].rep = newReplica(g, net, mod_x, mod_y, moduleCount, params->costModel);
+        seedRng(&slots[i].rng, getRandomSeed(), (uint64_t)i + 1);
+        slots[i].rlim = (g->rows > g->cols) ? g->rows : g->cols;
+        slots[i].accepted = 0;
+    }
+
+    long long bestCost = slots[0].rep->cost;
+
+    if (movableCount < 2) {
+        printf("Nothing to anneal: %d movable module(s).\n", movableCount);
+    } else {
+        // ---------------------------------------------------
+        // Temperature ladder: slot 0 hottest
+        // ---------------------------------------------------
+        int sampleCount = movableCount < 1000 ? movableCount : 1000;
+        int* deltas = new int[sampleCount];
+        Replica* r0 = slots[0].rep;
+        for (int k = 0; k < sampleCount; k++) {
+            int i = (int)rngBounded(&slots[0].rng, (uint32_t)movableCount);
+            int j = (int)rngBounded(&slots[0].rng, (uint32_t)movableCount);
+            while (j == i) {
+                j = (int)rngBounded(&slots[0].rng, (uint32_t)movableCount);
+            }
+            int a = movable[i];
+            int b = movable[j];
+            deltas[k] = r0->hpwl
+                ? computeDeltaHPWLSwap2D(r0->hpwl, net, r0->mod_x, r0->mod_y, a, b)
+                : computeDeltaCostSwapPacked2D(net, r0->g->modPos, a, b);
+        }
+        double Tmax = params->t0Scale * initialTemperature(deltas, sampleCount);
+        delete[] deltas;
+
+        double Tmin = SCHED_EXIT_EPS * bestCost / (net->netCount > 0 ? net->netCount : 1);
+        if (Tmin <= 0.0 || Tmin >= Tmax) Tmin = Tmax * 1e-3;
+
+        // rung spacing starts as the full-range ladder and narrows
+        // until exchanges pass at the target rate
+        double maxGap = log(Tmax / Tmin) / (replicas - 1);
+        double logGap = maxGap;
+
+        int workers = replicas < hardwareThreads() ? replicas : hardwareThreads();
+        WorkerPool* pool = createWorkerPool(workers);
+
+        SweepJob job;
+        job.slots = slots;
+        job.replicas = replicas;
+        job.workers = workers;
+        job.net = net;
+        job.params = params;
+        job.movable = movable;
+        job.movableCount = movableCount;
+
+        printf("Parallel tempering: %d replicas on %d threads, T = %.2f .. %.2f, %d rounds\n",
+               replicas, workers, Tmax / WEIGHT_ONE, Tmin / WEIGHT_ONE, rounds);
+
+        int* best_x = new int[moduleCount];
+        int* best_y = new int[moduleCount];
+        for (int m = 0; m < moduleCount; m++) {
+            best_x[m] = mod_x[m];
+            best_y[m] = mod_y[m];
+        }
+
+        long long exchanges = 0, exchangeTries = 0;
+        int windowAccepts = 0, windowTries = 0;
+        Rng* rng = threadRng();
+
+        for (int round = 0; round < rounds; round++) {
+            double progress = (rounds > 1) ? (double)round / (rounds - 1) : 1.0;
+            placeRungs(slots, replicas, Tmax * pow(Tmin / Tmax, progress), logGap, Tmax);
+
+            runOnPool(pool, sweepWorker, &job);
+
+            // windows follow each temperature's acceptance rate
+            if (params->moveGen == MOVE_WINDOW) {
+                for (int i = 0; i < replicas; i++)
+                    slots[i].rlim = updateWindowLimit2D(g, slots[i].rlim,
+                                                        (double)slots[i].accepted / movableCount);
+            }
+
+            // keep the best placement seen at a round boundary
+            for (int i = 0; i < replicas; i++) {
+                Replica* r = slots[i].rep;
+                if (r->cost < bestCost) {
+                    bestCost = r->cost;
+                    for (int m = 0; m < moduleCount; m++) {
+                        best_x[m] = r->mod_x[m];
+                        best_y[m] = r->mod_y[m];
+                    }
+                }
+            }
+
+            // exchange neighbors: even pairs on even rounds, odd pairs on odd
+            for (int i = round & 1; i + 1 < replicas; i += 2) {
+                TemperSlot* hot  = &slots[i];
+                TemperSlot* cold = &slots[i + 1];
+                if (hot->T <= cold->T) continue;   // both capped at Tmax
+
+                double x = (1.0 / hot->T - 1.0 / cold->T) *
+                           ((double)hot->rep->cost - cold->rep->cost);
+                exchangeTries++;
+                windowTries++;
+
+                if (x >= 0.0 || rngUniform(rng) < exp(x)) {
+                    Replica* tmp = hot->rep;
+                    hot->rep = cold->rep;
+                    cold->rep = tmp;
+                    exchanges++;
+                    windowAccepts++;
+                }
+            }
+
+            // steer the rung spacing toward the target exchange rate
+            if ((round + 1) % PT_ADAPT_ROUNDS == 0 && windowTries > 0) {
+                double rate = (double)windowAccepts / windowTries;
+                logGap *= (rate < PT_TARGET_EXCHANGE) ? 0.7 : 1.25;
+                if (logGap > maxGap) logGap = maxGap;
+                windowAccepts = 0;
+                windowTries = 0;
+            }
+
+            if ((round + 1) % 10 == 0 || round + 1 == rounds) {
+                printf("Round %d: T = %.2f .. %.2f, coldest = %lld, Best = %lld, exchanges %.1f%%\n",
+                       round + 1, slots[0].T / WEIGHT_ONE, slots[replicas - 1].T / WEIGHT_ONE,
+                       slots[replicas - 1].rep->cost, bestCost,
+                       exchangeTries ? 100.0 * exchanges / exchangeTries : 0.0);
+            }
+        }
+
+        destroyWorkerPool(pool);
+
+        for (int m = 0; m < moduleCount; m++) {
+            mod_x[m] = best_x[m];
+            mod_y[m] = best_y[m];
+        }
+        delete[] best_x;
+        delete[] best_y;
+
+        clearGrid(g);
+        for (int m = 0; m < moduleCount; m++)
+            placeModuleAt(g, m, mod_x[m], mod_y[m]);
+
+        printf("Final Best 2D Cost: %lld, exchanges accepted: %lld of %lld (%.1f%%)\n",
+               bestCost, exchanges, exchangeTries,
+               exchangeTries ? 100.0 * exchanges / exchangeTries : 0.0);
+    }
+
+    for (int i = 0; i < replicas; i++) freeReplica(slots[i].rep);
+    delete[] slots;
+    delete[] movable;
+
+    return bestCost;
+}
@@ -0,0 +1,42 @@
+#ifndef TEMPERING_H
+#define TEMPERING_H
+
+#include "grid.h"
+#include "netlist.h"
+#include "sa_timing.h"
+
+// ----------------------------------------------------------
+// Parallel tempering (replica exchange)
+//
+// 'replicas' placements anneal side by side on a worker pool, each
+// at its own temperature. After every round (one sweep of
+// movableCount moves per replica) neighboring temperatures may
+// trade placements under the exchange rule
+//     accept with min(1, exp((1/T_i - 1/T_j) * (E_i - E_j)))
+// alternating even and odd pairs. A trade swaps replica pointers;
+// no placement is copied.
+//
+// Ladder: rungs are spaced geometrically by a ratio that adapts
+// every PT_ADAPT_ROUNDS rounds toward PT_TARGET_EXCHANGE accepted
+// exchanges (a ladder spanning the whole schedule with a handful of
+// replicas trades almost never). The coldest rung follows the
+// schedule from its starting down to its exit temperature over the
+// rounds, hotter rungs sit above it (capped at the start
+// temperature), so the ladder anneals as a whole.
+//
+// Uses params->costModel, isFixed, moveGen, emptyMoveRate and
+// t0Scale; each rung keeps its own move window (MOVE_WINDOW). The
+// best placement seen at a round boundary is written back into g /
+// mod_x / mod_y and its cost returned. Replica k's RNG is stream
+// k + 1 of the global seed, so a run is reproducible for any thread
+// count.
+// ----------------------------------------------------------
+#define PT_DEFAULT_ROUNDS  150
+#define PT_TARGET_EXCHANGE 0.3    // accepted share of exchange attempts
+#define PT_ADAPT_ROUNDS    4      // rounds per ladder adjustment
+
+long long parallelTempering2D(Grid* g, Netlist* net, int mod_x[], int mod_y[],
+                              int moduleCount, const SAParams* params,
+                              int replicas, int rounds);
+
+#endif
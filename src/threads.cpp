@@ -0,0 +1,94 @@
+#include <mutex>
+#include <condition_variable>
+#include "threads.h"
+
+struct WorkerPool {
+    int size;
+    std::thread* helpers;
+
+    std::mutex lock;
+    std::condition_variable wake;   // helpers: new generation or stop
+    std::condition_variable done;   // caller: all helpers finished
+
+    unsigned long generation;
+    int pending;
+    int stop;
+
+    void (*fn)(void*, int);
+    void* ctx;
+};
+
+static void helperLoop(WorkerPool* p, int worker) {
+    unsigned long seen = 0;
+
+    while (true) {
+        std::unique_lock<std::mutex> lk(p->lock);
+        p->wake.wait(lk, [&] { return p->stop || p->generation != seen; });
+        if (p->stop) return;
+
+        seen = p->generation;
+        void (*fn)(void*, int) = p->fn;
+        void* ctx = p->ctx;
+        lk.unlock();
+
+        fn(ctx, worker);
+
+        lk.lock();
+        if (--p->pending == 0) p->done.notify_one();
+    }
+}
+
+WorkerPool* createWorkerPool(int size) {
+    WorkerPool* p = new WorkerPool;
+    p->size = (size > 0) ? size : 1;
+    p->generation = 0;
+    p->pending = 0;
+    p->stop = 0;
+    p->fn = nullptr;
+    p->ctx = nullptr;
+
+    p->helpers = new std::thread[p->size - 1];
+    for (int i = 1; i < p->size; i++)
+        p->helpers[i - 1] = std::thread(helperLoop, p, i);
+
+    return p;
+}
+
+void destroyWorkerPool(WorkerPool* p) {
+    if (!p) return;
+
+    {
+        std::lock_guard<std::mutex> lk(p->lock);
+        p->stop = 1;
+    }
+    p->wake.notify_all();
+
+    for (int i = 1; i < p->size; i++) p->helpers[i - 1].join();
+    delete[] p->helpers;
+    delete p;
+}
+
+int workerPoolSize(const WorkerPool* p) {
+    return p->size;
+}
+
+void runOnPool(WorkerPool* p, void (*fn)(void* ctx, int worker), void* ctx) {
+    if (p->size == 1) {
+        fn(ctx, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(p->lock);
+        p->fn = fn;
+        p->ctx = ctx;
+        p->pending = p->size - 1;
+        p->generation++;
+    }
+    p->wake.notify_all();
+
+    fn(ctx, 0);
+
+    std::unique_lock<std::mutex> lk(p->lock);
+    p->done.wait(lk, [&] { return p->pending == 0; });
+}
@@ -0,0 +1,41 @@
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <thread>
+
+// Run fn(i) for i in [0, count) on count threads (inline if count == 1)
+template <typename Fn>
+void runOnThreads(int count, Fn fn) {
+    if (count == 1) {
+        fn(0);
+        return;
+    }
+
+    std::thread* workers = new std::thread[count];
+    for (int i = 0; i < count; i++) workers[i] = std::thread(fn, i);
+    for (int i = 0; i < count; i++) workers[i].join();
+    delete[] workers;
+}
+
+// Hardware thread count (at least 1)
+inline int hardwareThreads() {
+    int n = (int)std::thread::hardware_concurrency();
+    return (n > 0) ? n : 1;
+}
+
+// ----------------------------------------------------------
+// Persistent worker pool for short, repeated parallel steps
+// (runOnThreads pays a thread start per call). The calling
+// thread is worker 0; size - 1 helper threads sleep between
+// calls.
+// ----------------------------------------------------------
+struct WorkerPool;
+
+WorkerPool* createWorkerPool(int size);
+void destroyWorkerPool(WorkerPool* pool);
+int workerPoolSize(const WorkerPool* pool);
+
+// Run fn(ctx, i) for every worker i in [0, size); returns when all are done
+void runOnPool(WorkerPool* pool, void (*fn)(void* ctx, int worker), void* ctx);
+
+#endif
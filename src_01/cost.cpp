@@ -16,22 +16,22 @@ int moduleDistance(int placement[], int a, int b) {
     return absInt(placement[a] - placement[b]);
 }
 
-int computeCost(Netlist* net, int placement[]) {
-    int total = 0;
+// -------------------------------------------------------
+// Full cost: weighted distance over the clique adjacency
+// (CSR rows offsets/neighbors/edgeWeights, fixed-point weights)
+// -------------------------------------------------------
+long long computeCost(Netlist* net, int placement[]) {
+    long long total = 0;
 
     for (int module = 0; module < net->moduleCount; module++) {
-        Node* curr = net->adj[module];
-
-        while (curr != NULL) {
-            int neighbor = curr->module;
+        for (int e = net->offsets[module]; e < net->offsets[module + 1]; e++) {
+            int neighbor = net->neighbors[e];
 
             // Avoid double counting: only count (module, neighbor) where neighbor > module
             if (neighbor > module) {
                 int dist = moduleDistance(placement, module, neighbor);
-                total += dist;  // weight = 1 for all nets (can expand later)
+                total += (long long)net->edgeWeights[e] * dist;
             }
-
-            curr = curr->next;
         }
     }
 
@@ -49,41 +49,31 @@ int computeDeltaCost(Netlist* net, int placement[], int i, int j) {
 
     int delta = 0;
 
-    // We need to evaluate only adjacency lists of modules i and j
+    // We need to evaluate only adjacency rows of modules i and j
     int modulesToCheck[2] = { i, j };
 
     for (int k = 0; k < 2; k++) {
         int mod = modulesToCheck[k];
 
-        Node* curr = net->adj[mod];
+        for (int e = net->offsets[mod]; e < net->offsets[mod + 1]; e++) {
+            int neigh = net->neighbors[e];
 
-        while (curr != NULL) {
-            int neigh = curr->module;
-
-            if (neigh == i || neigh == j) {
-                curr = curr->next;
+            if (neigh == i || neigh == j)
                 continue; // self-pair handled separately
-            }
 
             // Old distance
             int oldDist = absInt(placement[mod] - placement[neigh]);
 
             // Simulate swap
-            int newPosMod = (mod == i) ? old_j_pos : (mod == j) ? old_i_pos : placement[mod];
+            int newPosMod = (mod == i) ? old_j_pos : old_i_pos;
             int newPosNei = placement[neigh];
 
             int newDist = absInt(newPosMod - newPosNei);
 
-            delta += (newDist - oldDist);
-
-            curr = curr->next;
+            delta += net->edgeWeights[e] * (newDist - oldDist);
         }
     }
 
-    // Handle direct i ↔ j cost
-    int i_old = absInt(old_i_pos - old_j_pos);
-    int i_new = absInt(old_j_pos - old_i_pos);
-    delta += (i_new - i_old);
-
+    // Direct i <-> j edge: the swap keeps its length
     return delta;
 }
@@ -3,8 +3,8 @@
 
 #include "netlist.h"
 
-// Full cost computation
-int computeCost(Netlist* net, int placement[]);
+// Full cost computation (needs buildCliqueAdjacency)
+long long computeCost(Netlist* net, int placement[]);
 
 // Incremental cost computation for swapping two modules
 int computeDeltaCost(Netlist* net, int placement[], int i, int j);
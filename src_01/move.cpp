@@ -1,12 +1,11 @@
-#include <cstdlib>
-#include <ctime>
 #include "move.h"
+#include "rng.h"
 
 // ---------------------------------------------------------
 // Random integer in [min, max]
 // ---------------------------------------------------------
 int randInt(int min, int max) {
-    return min + (rand() % (max - min + 1));
+    return rngRange(threadRng(), min, max);
 }
 // ---------------------------------------------------------
 // Swap positions of modules i and j in the placement array
@@ -4,7 +4,8 @@
 #include "netlist.h"
 
 // --------------------------------------------------------------
-// Parse a netlist file into the adjacency-list Netlist structure
+// Parse a netlist file into the CSR Netlist (hypergraph plus
+// clique adjacency, unit net weights)
 //
 // Format:
 //   <moduleCount>
@@ -27,30 +28,44 @@ Netlist* parseNetlistFile(const char* filename, int* moduleCount) {
         return NULL;
     }
     // Read net count
-    if (fscanf(file, "%d", &netCount) != 1) {
+    if (fscanf(file, "%d", &netCount) != 1 || netCount < 0) {
         printf("Error: Could not read net count\n");
         fclose(file);
         return NULL;
     }
-    // Initialize netlist graph
-    Netlist* net = initNetlist(*moduleCount);
-    // Temporary array to store modules in a net
-    int modulesInNet[256];   // supports nets up to size 256
-    for (int n = 0; n < netCount; n++) {
+    // Collected nets: pins of net n are netPins[netOffsets[n] .. netOffsets[n+1]-1]
+    int pinCap = 4096, pinCount = 0;
+    int* netOffsets = (int*)malloc(sizeof(int) * (netCount + 1));
+    int* netPins    = (int*)malloc(sizeof(int) * pinCap);
+    netOffsets[0] = 0;
+
+    int n = 0;
+    for (; n < netCount; n++) {
         int k = 0;
-        if (fscanf(file, "%d", &k) != 1) {
+        if (fscanf(file, "%d", &k) != 1 || k < 0) {
             printf("Error: Could not read number of modules in net\n");
-            fclose(file);
-            return net;
+            break;
         }
         // Read the next k module IDs
         for (int i = 0; i < k; i++) {
-            fscanf(file, "%d", &modulesInNet[i]);
+            int id = -1;
+            if (fscanf(file, "%d", &id) != 1) break;
+            if (pinCount == pinCap) {
+                pinCap *= 2;
+                netPins = (int*)realloc(netPins, sizeof(int) * pinCap);
+            }
+            netPins[pinCount++] = id;
         }
-        // Add this net to the adjacency list
-        addNet(net, modulesInNet, k);
+        netOffsets[n + 1] = pinCount;
     }
 
     fclose(file);
+
+    // Nets read so far; invalid module IDs are dropped
+    Netlist* net = initNetlistFromNets(*moduleCount, n, netOffsets, netPins);
+    buildCliqueAdjacency(net);
+
+    free(netOffsets);
+    free(netPins);
     return net;
 }
@@ -1,12 +1,12 @@
-#include <cstdlib>
 #include <cmath>
-#include <ctime>
 #include <cstdio>
 
 #include "sa.h"
 #include "cost.h"
 #include "move.h"
 #include "netlist.h"
+#include "rng.h"
+#include "schedule.h"
 
 // -----------------------------------------------------------
 // Accept move using Metropolis criterion
@@ -18,7 +18,7 @@ int acceptMove(int delta, double T) {
     }
 
     double prob = exp(-((double)delta) / T);
-    double r = (double)rand() / RAND_MAX;
+    double r = rngUniform(threadRng());
 
     return (r < prob);
 }
@@ -33,34 +33,48 @@ int acceptMove(int delta, double T) {
 // -----------------------------------------------------------
 void simulatedAnnealing(Netlist* net, int placement[], int moduleCount) {
 
-    // ---------------------------
-    // SA parameters (adjustable)
-    // ---------------------------
-    double T      = 1000.0;     // initial temperature
-    double Tmin   = 0.001;      // stopping threshold
-    double alpha  = 0.97;       // cooling rate
     int iterationsPerT = 2000;  // inner loop
 
-    srand(time(NULL));
-
     // -----------------------------------------------------
     // Compute initial cost
     // -----------------------------------------------------
-    int currentCost = computeCost(net, placement);
+    long long currentCost = computeCost(net, placement);
 
-    // Best solution so far
+    // -----------------------------------------------------
+    // Adaptive schedule: T0 from the spread of random swap
+    // deltas, cooling and stop from acceptance statistics
+    // -----------------------------------------------------
+    int sampleCount = moduleCount < 1000 ? moduleCount : 1000;
+    int* deltas = new int[sampleCount];
+    for (int k = 0; k < sampleCount; k++) {
+        int i, j;
+        generateRandomSwap(placement, moduleCount, &i, &j);
+        deltas[k] = computeDeltaCost(net, placement, i, j);
+    }
+
+    AnnealSchedule sched;
+    initSchedule(&sched, initialTemperature(deltas, sampleCount), net->netCount);
+    delete[] deltas;
+
+    // Best solution so far: the current placement with the
+    // journaled swaps undone. Copied out to bestPlacement only
+    // when the journal fills up (journal then off until the
+    // next improvement).
     int* bestPlacement = new int[moduleCount];
-    for (int i = 0; i < moduleCount; i++)
-        bestPlacement[i] = placement[i];
+    int* journal = new int[2 * moduleCount];   // swap pairs since the best
+    int journalSize = 0;
+    int bestCopied = 0;
 
-    int bestCost = currentCost;
+    long long bestCost = currentCost;
 
-    printf("Initial Cost: %d\n", currentCost);
+    printf("Initial Cost: %lld\n", currentCost);
 
     // -----------------------------------------------------
     // Main SA loop
     // -----------------------------------------------------
-    while (T > Tmin) {
+    while (!sched.done) {
+        double T = sched.T;
+        int accepted = 0;
 
         for (int k = 0; k < iterationsPerT; k++) {
 
@@ -78,28 +92,49 @@ void simulatedAnnealing(Netlist* net, int placement[], int moduleCount) {
                 // Apply swap
                 swapModules(placement, i, j);
                 currentCost += delta;
+                accepted++;
 
                 // Track best solution
                 if (currentCost < bestCost) {
                     bestCost = currentCost;
-                    for (int a = 0; a < moduleCount; a++)
-                        bestPlacement[a] = placement[a];
+                    journalSize = 0;
+                    bestCopied = 0;
+                } else if (!bestCopied) {
+                    if (journalSize == moduleCount) {
+                        // best = placement before this swap, minus the journal
+                        for (int a = 0; a < moduleCount; a++)
+                            bestPlacement[a] = placement[a];
+                        swapModules(bestPlacement, i, j);
+                        for (int e = journalSize - 1; e >= 0; e--)
+                            swapModules(bestPlacement, journal[2 * e], journal[2 * e + 1]);
+                        bestCopied = 1;
+                    } else {
+                        journal[2 * journalSize]     = i;
+                        journal[2 * journalSize + 1] = j;
+                        journalSize++;
+                    }
                 }
 
             }
         }
 
         // Cool down
-        T = T * alpha;
+        advanceSchedule(&sched, accepted, iterationsPerT, currentCost);
     }
 
-    printf("Final Best Cost: %d\n", bestCost);
+    printf("Final Best Cost: %lld\n", bestCost);
 
     // Copy best placement into output
-    for (int i = 0; i < moduleCount; i++)
-        placement[i] = bestPlacement[i];
+    if (bestCopied) {
+        for (int i = 0; i < moduleCount; i++)
+            placement[i] = bestPlacement[i];
+    } else {
+        for (int e = journalSize - 1; e >= 0; e--)
+            swapModules(placement, journal[2 * e], journal[2 * e + 1]);
+    }
 
     delete[] bestPlacement;
+    delete[] journal;
 }
 void printPlacement(int placement[], int moduleCount) {
 
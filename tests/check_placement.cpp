@@ -0,0 +1,431 @@
+// ----------------------------------------------------------
+// Consistency checks against the 5k fixtures
+//
+// Build and run from the repository root:
+//   g++ -O2 -pthread -Isrc -o check_placement tests/check_placement.cpp $(ls src/*.cpp | grep -v main.cpp)
+//   ./check_placement [--seed N]
+//
+// Exits non-zero if any check fails.
+// ----------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#include "csv_parser.h"
+#include "netlist.h"
+#include "netlist_cache.h"
+#include "grid.h"
+#include "random2D.h"
+#include "cost2D.h"
+#include "delta_simd.h"
+#include "hpwl2D.h"
+#include "reorder.h"
+#include "rng.h"
+
+static const char* NETS_FILE = "tests/nets_5k.csv";
+static const char* CACHE_FILE = "tests/check_placement.csv.bin";
+static const char* SOURCE_COPY = "tests/check_placement.csv";
+
+#define CHECK_ROWS  80
+#define CHECK_COLS  80
+#define CHECK_MOVES 2000   // random moves per delta check
+#define CHECK_ROWS_SIMD 20000   // random rows per kernel check
+#define CHECK_ROW_MAX   70      // longest random row (covers the vector tails)
+
+static int failures = 0;
+
+static void report(const char* name, int ok) {
+    printf("%-44s %s\n", name, ok ? "ok" : "FAILED");
+    if (!ok) failures++;
+}
+
+static int sameInts(const int* a, const int* b, int count) {
+    return count == 0 || memcmp(a, b, sizeof(int) * count) == 0;
+}
+
+// Same hypergraph: counts, net -> pins, weights and module -> nets
+static int sameHypergraph(const Netlist* a, const Netlist* b) {
+    if (a->moduleCount != b->moduleCount || a->netCount != b->netCount) return 0;
+    if (!sameInts(a->netOffsets, b->netOffsets, a->netCount + 1)) return 0;
+    if (!sameInts(a->netPins, b->netPins, a->netOffsets[a->netCount])) return 0;
+    if (!sameInts(a->netWeights, b->netWeights, a->netCount)) return 0;
+    if (!sameInts(a->modOffsets, b->modOffsets, a->moduleCount + 1)) return 0;
+    return sameInts(a->modNets, b->modNets, a->modOffsets[a->moduleCount]);
+}
+
+// ----------------------------------------------------------
+// Parsing and the binary cache
+// ----------------------------------------------------------
+static void checkThreadedParse(const Netlist* serial) {
+    int moduleCount = 0;
+    Netlist* threaded = parseCSVNetlist(NETS_FILE, &moduleCount, 4);
+    report("threaded parse == single-threaded parse", threaded && sameHypergraph(serial, threaded));
+    if (threaded) freeNetlist(threaded);
+}
+
+static void checkCacheRoundTrip(const Netlist* serial) {
+    int ok = writeNetlistCache(CACHE_FILE, NETS_FILE, serial);
+    if (ok) {
+        int moduleCount = 0;
+        Netlist* cached = loadNetlistCache(CACHE_FILE, NETS_FILE, &moduleCount, 1);
+        ok = cached && moduleCount == serial->moduleCount && sameHypergraph(serial, cached);
+        if (cached) freeNetlist(cached);
+    }
+    remove(CACHE_FILE);
+    report("cache write + verified load == CSV parse", ok);
+}
+
+// Copy a file byte for byte; returns 1 on success
+static int copyFile(const char* from, const char* to) {
+    FILE* in = fopen(from, "rb");
+    if (!in) return 0;
+    FILE* out = fopen(to, "wb");
+    if (!out) {
+        fclose(in);
+        return 0;
+    }
+    char buf[65536];
+    size_t n;
+    int ok = 1;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0)
+        if (fwrite(buf, 1, n, out) != n) ok = 0;
+    fclose(in);
+    if (fclose(out) != 0) ok = 0;
+    return ok;
+}
+
+// Overwrite one byte at offset (from the end if offset < 0)
+static int patchByte(const char* path, long offset, int value) {
+    FILE* fp = fopen(path, "r+b");
+    if (!fp) return 0;
+    int ok = fseek(fp, offset, offset < 0 ? SEEK_END : SEEK_SET) == 0 && fputc(value, fp) != EOF;
+    if (fclose(fp) != 0) ok = 0;
+    return ok;
+}
+
+// ----------------------------------------------------------
+// Damaged caches and sources the fast path can't see by size/mtime
+// ----------------------------------------------------------
+static void checkCacheCorruption(const Netlist* serial) {
+    int moduleCount = 0;
+
+    // out-of-range net ID in the last modNets entry (last bytes of the file)
+    int ok = writeNetlistCache(CACHE_FILE, NETS_FILE, serial) && patchByte(CACHE_FILE, -1, 0x7f);
+    Netlist* loaded = ok ? loadNetlistCache(CACHE_FILE, NETS_FILE, &moduleCount) : nullptr;
+    report("cache: bad net ID rejected on every load", ok && !loaded);
+    if (loaded) freeNetlist(loaded);
+
+    // same-size edit of the source with its mtime put back: only the
+    // source hash (verification) can tell
+    ok = copyFile(NETS_FILE, SOURCE_COPY) && writeNetlistCache(CACHE_FILE, SOURCE_COPY, serial);
+    struct stat st;
+    ok = ok && stat(SOURCE_COPY, &st) == 0 && patchByte(SOURCE_COPY, -2, '9');
+    if (ok) {
+        struct timespec times[2] = { st.st_atim, st.st_mtim };
+        ok = utimensat(AT_FDCWD, SOURCE_COPY, times, 0) == 0;
+    }
+    loaded = ok ? loadNetlistCache(CACHE_FILE, SOURCE_COPY, &moduleCount) : nullptr;
+    ok = ok && loaded;   // the fast path still trusts it
+    if (loaded) freeNetlist(loaded);
+    loaded = ok ? loadNetlistCache(CACHE_FILE, SOURCE_COPY, &moduleCount, 1) : nullptr;
+    report("cache: same-size source edit caught by verify", ok && !loaded);
+    if (loaded) freeNetlist(loaded);
+
+    remove(CACHE_FILE);
+    remove(SOURCE_COPY);
+}
+
+// ----------------------------------------------------------
+// RCM renumbering: permuting by rank and back by order is the identity
+// ----------------------------------------------------------
+static void checkReorderIdentity(const Netlist* net) {
+    int n = net->moduleCount;
+    int* order = new int[n];
+    int* rank = new int[n];
+    computeModuleOrder(net, REORDER_RCM, order, rank);
+
+    int ok = 1;
+    for (int m = 0; m < n; m++)
+        if (rank[order[m]] != m) ok = 0;
+    report("RCM order and rank are inverse", ok);
+
+    int* a = new int[n];
+    for (int m = 0; m < n; m++) a[m] = m * 7 + 1;
+    permuteModuleInts(a, order, n);
+    unpermuteModuleInts(a, order, n);
+    ok = 1;
+    for (int m = 0; m < n; m++)
+        if (a[m] != m * 7 + 1) ok = 0;
+    report("permute + unpermute module arrays", ok);
+
+    Netlist* permuted = permuteNetlist(net, rank);
+    Netlist* restored = permuteNetlist(permuted, order);
+    report("permute + unpermute netlist", sameHypergraph(net, restored));
+
+    freeNetlist(restored);
+    freeNetlist(permuted);
+    delete[] a;
+    delete[] rank;
+    delete[] order;
+}
+
+// ----------------------------------------------------------
+// Every row kernel this CPU runs agrees with the scalar one on random
+// rows (lengths 0..CHECK_ROW_MAX, random skip, weights up to 2^20)
+// ----------------------------------------------------------
+static void checkRowKernels(int moduleCount) {
+    const RowDeltaKernel* kernels[8];
+    int count = availableRowDeltaKernels(kernels, 8);
+
+    Rng* rng = threadRng();
+    int* mod_x = new int[moduleCount];
+    int* mod_y = new int[moduleCount];
+    unsigned int* pos = new unsigned int[moduleCount];
+    for (int m = 0; m < moduleCount; m++) {
+        mod_x[m] = rngRange(rng, 0, GRID_MAX_DIM - 1);
+        mod_y[m] = rngRange(rng, 0, GRID_MAX_DIM - 1);
+        pos[m] = POS_PACK(mod_x[m], mod_y[m]);
+    }
+
+    int neighbors[CHECK_ROW_MAX + 3];
+    int weights[CHECK_ROW_MAX + 3];
+    int mismatches = 0;
+
+    for (int t = 0; t < CHECK_ROWS_SIMD && mismatches < 5; t++) {
+        // offset start: unaligned rows as in the CSR arrays
+        int begin = rngRange(rng, 0, 3);
+        int end = begin + rngRange(rng, 0, CHECK_ROW_MAX);
+        for (int e = begin; e < end; e++) {
+            neighbors[e] = (int)rngBounded(rng, (uint32_t)moduleCount);
+            weights[e] = rngRange(rng, 1, 1 << 20);
+        }
+        int skip = (end > begin && rngUniform(rng) < 0.5)
+            ? neighbors[rngRange(rng, begin, end - 1)] : -1;
+
+        int old_x = rngRange(rng, 0, GRID_MAX_DIM - 1), old_y = rngRange(rng, 0, GRID_MAX_DIM - 1);
+        int new_x = rngRange(rng, 0, GRID_MAX_DIM - 1), new_y = rngRange(rng, 0, GRID_MAX_DIM - 1);
+
+        int ref = kernels[0]->rowDelta(neighbors, weights, begin, end, mod_x, mod_y,
+                                       old_x, old_y, new_x, new_y, skip);
+
+        for (int k = 0; k < count; k++) {
+            int plain = kernels[k]->rowDelta(neighbors, weights, begin, end, mod_x, mod_y,
+                                             old_x, old_y, new_x, new_y, skip);
+            int packed = kernels[k]->rowDeltaPacked(neighbors, weights, begin, end, pos,
+                                                    POS_PACK(old_x, old_y), POS_PACK(new_x, new_y),
+                                                    skip);
+            if (plain != ref || packed != ref) {
+                printf("  %s row %d (length %d): %d / packed %d, scalar %d\n",
+                       kernels[k]->name, t, end - begin, plain, packed, ref);
+                mismatches++;
+            }
+        }
+    }
+
+    char name[64] = "row kernels agree:";
+    for (int k = 0; k < count; k++) {
+        strncat(name, " ", sizeof(name) - strlen(name) - 1);
+        strncat(name, kernels[k]->name, sizeof(name) - strlen(name) - 1);
+    }
+    report(name, mismatches == 0);
+
+    delete[] pos;
+    delete[] mod_x;
+    delete[] mod_y;
+}
+
+// ----------------------------------------------------------
+// Incremental deltas vs. full recomputation over random moves
+// ----------------------------------------------------------
+
+// Random swap of two modules, or a move to a free cell (m2 = -1)
+static void pickMove(Grid* g, Rng* rng, int moduleCount, int* m1, int* m2, int* r, int* c) {
+    *m1 = (int)rngBounded(rng, (uint32_t)moduleCount);
+    if (g->freeCount > 0 && rngUniform(rng) < 0.3) {
+        indexToRC(g, freeSiteAt(g, (int)rngBounded(rng, (uint32_t)g->freeCount)), r, c);
+        *m2 = -1;
+        return;
+    }
+    do {
+        *m2 = (int)rngBounded(rng, (uint32_t)moduleCount);
+    } while (*m2 == *m1);
+}
+
+static void checkCliqueDeltas(const char* name, Netlist* net, Grid* g, int mod_x[], int mod_y[]) {
+    Rng* rng = threadRng();
+    long long cost = computeCost2D(net, mod_x, mod_y);
+    int ok = cost == computeCostPacked2D(net, g->modPos);
+    int mismatches = 0;
+
+    for (int k = 0; k < CHECK_MOVES && mismatches < 5; k++) {
+        int m1, m2, r = 0, c = 0;
+        pickMove(g, rng, net->moduleCount, &m1, &m2, &r, &c);
+
+        int delta, packed;
+        if (m2 < 0) {
+            delta = computeDeltaCostMove2D(net, mod_x, mod_y, m1, r, c);
+            packed = computeDeltaCostMovePacked2D(net, g->modPos, m1, r, c);
+            moveModuleTo(g, mod_x, mod_y, m1, r, c);
+        } else {
+            delta = computeDeltaCostSwap2D(net, mod_x, mod_y, m1, m2);
+            packed = computeDeltaCostSwapPacked2D(net, g->modPos, m1, m2);
+            swapModules2D(g, mod_x, mod_y, m1, m2);
+        }
+
+        long long full = computeCost2D(net, mod_x, mod_y);
+        if (delta != packed || cost + delta != full) {
+            printf("  clique move %d (%d, %d): delta %d, packed %d, full %lld\n",
+                   k, m1, m2, delta, packed, full - cost);
+            mismatches++;
+        }
+        cost = full;
+    }
+    report(name, ok && mismatches == 0);
+}
+
+static void checkHPWLDeltas(const char* name, Netlist* net, Grid* g, int mod_x[], int mod_y[]) {
+    Rng* rng = threadRng();
+    HPWLState2D* s = initHPWLState2D(net, mod_x, mod_y);
+    long long cost = computeCostHPWL2D(net, mod_x, mod_y);
+    int mismatches = 0;
+
+    for (int k = 0; k < CHECK_MOVES && mismatches < 5; k++) {
+        int m1, m2, r = 0, c = 0;
+        pickMove(g, rng, net->moduleCount, &m1, &m2, &r, &c);
+
+        int delta;
+        if (m2 < 0) {
+            delta = computeDeltaHPWLMove2D(s, net, mod_x, mod_y, m1, r, c);
+            moveModuleTo(g, mod_x, mod_y, m1, r, c);
+        } else {
+            delta = computeDeltaHPWLSwap2D(s, net, mod_x, mod_y, m1, m2);
+            swapModules2D(g, mod_x, mod_y, m1, m2);
+        }
+        commitHPWLMove2D(s);
+
+        long long full = computeCostHPWL2D(net, mod_x, mod_y);
+        if (cost + delta != full) {
+            printf("  HPWL move %d (%d, %d): delta %d, full %lld\n", k, m1, m2, delta, full - cost);
+            mismatches++;
+        }
+        cost = full;
+    }
+
+    // the cached boxes must still describe the placement
+    HPWLState2D* fresh = initHPWLState2D(net, mod_x, mod_y);
+    int sameBoxes = memcmp(s->boxes, fresh->boxes, sizeof(NetBox) * net->netCount) == 0;
+    freeHPWLState2D(fresh);
+    freeHPWLState2D(s);
+
+    report(name, mismatches == 0 && sameBoxes);
+}
+
+// ----------------------------------------------------------
+// A module listed twice on a net keeps one pin, and the deltas stay
+// exact on such a netlist (the 5k fixtures never repeat a pin)
+// ----------------------------------------------------------
+static void checkDuplicatePins() {
+    const int offsets[] = { 0, 4, 6, 11, 14 };
+    const int pins[]    = { 0, 1, 1, 2,   3, 3,   1, 2, 3, 1, 0,   4, 0, 4 };
+    Netlist* net = initNetlistFromNets(5, 4, offsets, pins);
+
+    const int wantOffsets[] = { 0, 3, 4, 8, 10 };
+    const int wantPins[]    = { 0, 1, 2,   3,   1, 2, 3, 0,   4, 0 };
+    report("repeated pins dropped per net",
+           sameInts(net->netOffsets, wantOffsets, 5) && sameInts(net->netPins, wantPins, 10) &&
+           net->modOffsets[5] == 10);
+
+    buildCliqueAdjacency(net);
+
+    Grid* g = initGrid(3, 3);
+    int mod_x[5], mod_y[5];
+    randomInitialPlacement2D(g, 5, mod_x, mod_y);
+    initGridPositions(g, 5);
+
+    checkCliqueDeltas("repeated pins: clique deltas == recompute", net, g, mod_x, mod_y);
+    checkHPWLDeltas("repeated pins: HPWL deltas == recompute", net, g, mod_x, mod_y);
+
+    freeGrid(g);
+    freeNetlist(net);
+}
+
+// ----------------------------------------------------------
+// A net above CLIQUE_MAX_FANOUT stays in the hypergraph but out of
+// the clique adjacency
+// ----------------------------------------------------------
+static void checkHighFanoutNet() {
+    int big = CLIQUE_MAX_FANOUT + 1;
+    int* offsets = new int[3];
+    int* pins = new int[big + 2];
+    for (int p = 0; p < big; p++) pins[p] = p;
+    pins[big] = 0;
+    pins[big + 1] = big;
+    offsets[0] = 0;
+    offsets[1] = big;
+    offsets[2] = big + 2;
+
+    Netlist* net = initNetlistFromNets(big + 1, 2, offsets, pins);
+    int ok = buildCliqueAdjacency(net) && netFanout(net, 0) == big;
+    ok = ok && moduleDegree(net, 0) == 1 && net->neighbors[net->offsets[0]] == big;
+    for (int m = 1; m < big && ok; m++)
+        if (moduleDegree(net, m) != 0) ok = 0;
+    report("high-fanout net left out of the clique", ok);
+
+    freeNetlist(net);
+    delete[] pins;
+    delete[] offsets;
+}
+
+int main(int argc, char** argv) {
+    unsigned long long seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else {
+            printf("Usage: %s [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+    setRandomSeed(seed);
+    initNodePool(0);
+
+    int moduleCount = 0;
+    Netlist* net = parseCSVNetlist(NETS_FILE, &moduleCount, 1);
+    if (!net) {
+        printf("Failed to parse netlist file: %s (run from the repository root)\n", NETS_FILE);
+        return 1;
+    }
+    printf("%s: %d modules, %d nets, seed %llu, delta kernel %s\n",
+           NETS_FILE, moduleCount, net->netCount, seed, rowDeltaKernelName());
+
+    checkThreadedParse(net);
+    checkCacheRoundTrip(net);
+    checkCacheCorruption(net);
+    checkReorderIdentity(net);
+    checkRowKernels(moduleCount);
+    checkDuplicatePins();
+    checkHighFanoutNet();
+
+    buildCliqueAdjacency(net);
+
+    Grid* g = initGrid(CHECK_ROWS, CHECK_COLS);
+    int* mod_x = new int[moduleCount];
+    int* mod_y = new int[moduleCount];
+    randomInitialPlacement2D(g, moduleCount, mod_x, mod_y);
+    initGridPositions(g, moduleCount);
+
+    checkCliqueDeltas("clique swap/move deltas == full recompute", net, g, mod_x, mod_y);
+    checkHPWLDeltas("HPWL swap/move deltas == full recompute", net, g, mod_x, mod_y);
+
+    delete[] mod_x;
+    delete[] mod_y;
+    freeGrid(g);
+    freeNetlist(net);
+    freeNodePool();
+
+    if (failures) printf("%d check(s) FAILED\n", failures);
+    else printf("All checks passed\n");
+    return failures ? 1 : 0;
+}